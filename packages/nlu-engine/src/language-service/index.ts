@@ -92,7 +92,12 @@ export default class LanguageService implements ILanguageService {
     }
 
     this.logger?.info(`Found Languages: ${!languages.length ? 'None' : languages.join(', ')}`)
-    await Bluebird.mapSeries(languages, this._loadModels.bind(this))
+    await Bluebird.mapSeries(languages, async (lang, i) => {
+      // the file of the next language is read from disk while this one loads
+      const next = languages[i + 1]
+      const prefetching = next ? MLToolkit.FastText.prefetch(this._models[next].fastTextModel.path) : Promise.resolve(0)
+      await Promise.all([this._loadModels(lang), prefetching])
+    })
 
     this._ready = true
   }
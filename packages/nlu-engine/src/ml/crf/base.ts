@@ -39,9 +39,7 @@ export class CRFTagger
     const trainer = await makeTrainer({ debug: false })
     trainer.set_params(options)
 
-    for (const { features, labels } of elements) {
-      trainer.append(features, labels)
-    }
+    trainer.append_batch(elements.map(({ features }) => features), elements.map(({ labels }) => labels))
 
     const crfModelFilename = tmp.fileSync({ postfix: '.bin' }).name
 
@@ -58,9 +56,7 @@ export class CRFTagger
 
   public async load({ content: crfModel }: CRFTaggerModel): Promise<void> {
     const tagger = await makeTagger()
-    const crfModelFn = tmp.tmpNameSync()
-    fse.writeFileSync(crfModelFn, crfModel)
-    const success = tagger.open(crfModelFn)
+    const success = tagger.open(crfModel)
 
     if (!success) {
       throw new Error('CRF Tagger could not open model.')
@@ -73,13 +69,13 @@ export class CRFTagger
     if (!this.tagger) {
       throw new Error(`${CRFTagger._displayName} must load model before calling predict.`)
     }
-    return this.tagger.tag(xseq)
+    return this.tagger.tagAsync(xseq)
   }
 
   public async marginal(xseq: string[][]): Promise<MarginalPrediction[]> {
     if (!this.tagger) {
       throw new Error(`${CRFTagger._displayName} must load model before calling marginal.`)
     }
-    return this.tagger.marginal(xseq)
+    return this.tagger.marginalAsync(xseq)
   }
 }
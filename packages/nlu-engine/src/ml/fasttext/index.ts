@@ -1,4 +1,4 @@
-import { makeClassifier, makeQuery, Options, Query } from '@botpress/node-fasttext'
+import { makeClassifier, makeQuery, prefetchModel, Options, Query } from '@botpress/node-fasttext'
 import Bluebird from 'bluebird'
 import { VError } from 'verror'
 
@@ -9,6 +9,9 @@ const FAST_TEXT_CLEANUP_MS = parseInt(process.env.FAST_TEXT_CLEANUP_MS || '60000
 
 export * from './typings'
 
+/** Reads a model file into the OS page cache in the background, so its later load reads from memory. */
+export const prefetch = (modelPath: string): Promise<number> => prefetchModel(modelPath)
+
 export const DefaultTrainArgs: Partial<TrainArgs> = {
   bucket: 25000,
   dim: 15,
@@ -133,7 +136,7 @@ export class Model {
     this._queryPromise = new Promise(async (resolve, reject) => {
       try {
         const q = await makeQuery(this.modelPath)
-        await q.getWordVector('hydrate') // hydration as fastText loads models lazily
+        await q.load() // fastText loads models lazily
         resolve(q)
         this._resetQueryBomb()
       } catch (thrown) {
@@ -81,13 +81,17 @@
         "crfsuite/lib/crf/src/train_l2sgd.c",
         "crfsuite/lib/crf/src/train_lbfgs.c",
         "crfsuite/lib/crf/src/train_passive_aggressive.c",
+        "crfsuite/lib/crf/src/vecmath.c",
 
         "crfsuite/lib/cqdb/src/cqdb.c",
         "crfsuite/lib/cqdb/src/lookup3.c",
 
         "cppsrc/main.cc",
+        "cppsrc/node_attributes.cc",
         "cppsrc/trainer_class.cc",
         "cppsrc/tagger_class.cc",
+        "cppsrc/tagger_model.cc",
+        "cppsrc/tagging_worker.cc",
         "cppsrc/node_trainer.cc",
         "cppsrc/training_worker.cc"
       ],
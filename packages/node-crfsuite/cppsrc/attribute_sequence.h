@@ -0,0 +1,25 @@
+#ifndef _ATTRIBUTE_SEQUENCE_H_
+#define _ATTRIBUTE_SEQUENCE_H_
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * The attributes of a sequence, given by id instead of by name. The
+ * attributes of item t are ids[offsets[t]] .. ids[offsets[t + 1] - 1], with
+ * the same entries of weights (all 1 when weights is empty). Negative ids
+ * (unknown attributes) are skipped.
+ */
+struct AttributeSequence
+{
+  std::vector<int32_t> offsets;
+  std::vector<int32_t> ids;
+  std::vector<double> weights;
+
+  size_t size() const
+  {
+    return offsets.empty() ? 0 : offsets.size() - 1;
+  }
+};
+
+#endif
@@ -0,0 +1,86 @@
+#include "node_attributes.h"
+
+#include <string.h>
+
+static bool IsTypedArray(Napi::Value value, napi_typedarray_type type)
+{
+  return value.IsTypedArray() && value.As<Napi::TypedArray>().TypedArrayType() == type;
+}
+
+bool IsAttributeSequence(Napi::Value xseq)
+{
+  return xseq.IsObject() && !xseq.IsArray();
+}
+
+AttributeSequence GetAttributeSequence(Napi::Value value, std::string &err)
+{
+  AttributeSequence xseq;
+
+  Napi::Object obj = value.As<Napi::Object>();
+  Napi::Value ids = obj.Get("ids");
+  Napi::Value offsets = obj.Get("offsets");
+  Napi::Value weights = obj.Get("weights");
+  if (!IsTypedArray(ids, napi_int32_array) || !IsTypedArray(offsets, napi_int32_array))
+  {
+    err = "ids and offsets must be Int32Arrays";
+    return xseq;
+  }
+
+  Napi::Int32Array napiIds = ids.As<Napi::Int32Array>();
+  Napi::Int32Array napiOffsets = offsets.As<Napi::Int32Array>();
+  xseq.ids.assign(napiIds.Data(), napiIds.Data() + napiIds.ElementLength());
+  xseq.offsets.assign(napiOffsets.Data(), napiOffsets.Data() + napiOffsets.ElementLength());
+
+  if (xseq.offsets.empty() || xseq.offsets.front() != 0 || xseq.offsets.back() != (int32_t)xseq.ids.size())
+  {
+    err = "offsets must start at 0 and end at the number of ids";
+    return xseq;
+  }
+  for (size_t t = 1; t < xseq.offsets.size(); ++t)
+  {
+    if (xseq.offsets[t] < xseq.offsets[t - 1])
+    {
+      err = "offsets must not decrease";
+      return xseq;
+    }
+  }
+
+  if (!weights.IsUndefined())
+  {
+    if (!IsTypedArray(weights, napi_float32_array) ||
+        weights.As<Napi::Float32Array>().ElementLength() != xseq.ids.size())
+    {
+      err = "weights must be a Float32Array of the same length as ids";
+      return xseq;
+    }
+    Napi::Float32Array napiWeights = weights.As<Napi::Float32Array>();
+    xseq.weights.assign(napiWeights.Data(), napiWeights.Data() + napiWeights.ElementLength());
+  }
+
+  return xseq;
+}
+
+CRFSuite::StringList GetAttributeNames(Napi::Value value, std::string &err)
+{
+  CRFSuite::StringList names;
+  if (!value.IsArray())
+  {
+    err = "names must be an array of strings";
+    return names;
+  }
+
+  Napi::Array array = value.As<Napi::Array>();
+  names.reserve(array.Length());
+  for (uint32_t i = 0; i < array.Length(); ++i)
+  {
+    names.push_back(array.Get(i).ToString().Utf8Value());
+  }
+  return names;
+}
+
+Napi::Value AttributeIdsToNapi(Napi::Env env, const std::vector<int32_t> &ids)
+{
+  Napi::Int32Array result = Napi::Int32Array::New(env, ids.size());
+  memcpy(result.Data(), ids.data(), ids.size() * sizeof(int32_t));
+  return result;
+}
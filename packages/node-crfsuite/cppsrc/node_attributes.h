@@ -0,0 +1,30 @@
+#ifndef _NODE_ATTRIBUTES_H_
+#define _NODE_ATTRIBUTES_H_
+
+#include <string>
+#include <vector>
+#include <napi.h>
+#include <crfsuite_api.hpp>
+
+#include "attribute_sequence.h"
+
+/**
+ * Whether xseq gives its attributes by id, as
+ * { ids: Int32Array, offsets: Int32Array, weights?: Float32Array },
+ * rather than as an array of arrays of attribute names.
+ */
+bool IsAttributeSequence(Napi::Value xseq);
+
+/**
+ * Copies an attribute sequence given by id, err is set when it is malformed.
+ */
+AttributeSequence GetAttributeSequence(Napi::Value xseq, std::string &err);
+
+/**
+ * Attribute names, without the ":weight" suffix of the attributes of an xseq.
+ */
+CRFSuite::StringList GetAttributeNames(Napi::Value names, std::string &err);
+
+Napi::Value AttributeIdsToNapi(Napi::Env env, const std::vector<int32_t> &ids);
+
+#endif
@@ -1,3 +1,8 @@
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <crfsuite.h>
 #include "node_trainer.h"
 
 NodeTrainer::NodeTrainer(bool debug) : CRFSuite::Trainer()
@@ -5,6 +10,134 @@ NodeTrainer::NodeTrainer(bool debug) : CRFSuite::Trainer()
   this->debug = debug;
 }
 
+std::vector<int32_t> NodeTrainer::attributeIds(const CRFSuite::StringList &names)
+{
+  if (data->attrs == NULL || data->labels == NULL)
+  {
+    init();
+  }
+
+  std::vector<int32_t> ids(names.size());
+  for (size_t i = 0; i < names.size(); ++i)
+  {
+    ids[i] = data->attrs->get(data->attrs, names[i].c_str());
+  }
+  return ids;
+}
+
+AttributeSequence NodeTrainer::resolve(const CRFSuite::ItemSequence &xseq)
+{
+  if (data->attrs == NULL || data->labels == NULL)
+  {
+    init();
+  }
+
+  AttributeSequence result;
+  result.offsets.reserve(xseq.size() + 1);
+  result.offsets.push_back(0);
+  for (const CRFSuite::Item &item : xseq)
+  {
+    for (const CRFSuite::Attribute &attr : item)
+    {
+      result.ids.push_back(data->attrs->get(data->attrs, attr.attr.c_str()));
+      result.weights.push_back(attr.value);
+    }
+    result.offsets.push_back((int32_t)result.ids.size());
+  }
+  return result;
+}
+
+void NodeTrainer::append(const AttributeSequence &xseq, const CRFSuite::StringList &yseq, int group)
+{
+  if (data->attrs == NULL || data->labels == NULL)
+  {
+    init();
+  }
+
+  check(xseq, yseq);
+  add(xseq, yseq, group);
+}
+
+void NodeTrainer::append(const std::vector<AttributeSequence> &xseqs, const std::vector<CRFSuite::StringList> &yseqs, int group)
+{
+  if (data->attrs == NULL || data->labels == NULL)
+  {
+    init();
+  }
+
+  if (xseqs.size() != yseqs.size())
+  {
+    std::stringstream ss;
+    ss << "The numbers of sequences and label sequences differ: " << xseqs.size() << " != " << yseqs.size();
+    throw std::invalid_argument(ss.str());
+  }
+
+  for (size_t i = 0; i < xseqs.size(); ++i)
+  {
+    check(xseqs[i], yseqs[i]);
+  }
+
+  if (crfsuite_data_reserve(data, (int)xseqs.size()) != 0)
+  {
+    throw std::runtime_error("Out of memory.");
+  }
+
+  for (size_t i = 0; i < xseqs.size(); ++i)
+  {
+    add(xseqs[i], yseqs[i], group);
+  }
+}
+
+void NodeTrainer::check(const AttributeSequence &xseq, const CRFSuite::StringList &yseq)
+{
+  if (data->attrs == NULL || data->labels == NULL)
+  {
+    init();
+  }
+
+  if (xseq.size() != yseq.size())
+  {
+    std::stringstream ss;
+    ss << "The numbers of items and labels differ: |x| = " << xseq.size() << ", |y| = " << yseq.size();
+    throw std::invalid_argument(ss.str());
+  }
+
+  const int32_t numAttrs = data->attrs->num(data->attrs);
+  for (int32_t aid : xseq.ids)
+  {
+    if (aid < 0 || numAttrs <= aid)
+    {
+      throw std::invalid_argument("Unknown attribute id, ids must be obtained from this trainer");
+    }
+  }
+}
+
+void NodeTrainer::add(const AttributeSequence &xseq, const CRFSuite::StringList &yseq, int group)
+{
+  crfsuite_instance_t _inst;
+  crfsuite_instance_init_n(&_inst, xseq.size());
+  for (size_t t = 0; t < xseq.size(); ++t)
+  {
+    crfsuite_item_t *_item = &_inst.items[t];
+    crfsuite_item_init_n(_item, xseq.offsets[t + 1] - xseq.offsets[t]);
+    for (int32_t k = xseq.offsets[t]; k < xseq.offsets[t + 1]; ++k)
+    {
+      _item->contents[k - xseq.offsets[t]].aid = xseq.ids[k];
+      _item->contents[k - xseq.offsets[t]].value = (floatval_t)(xseq.weights.empty() ? 1. : xseq.weights[k]);
+    }
+    _inst.labels[t] = data->labels->get(data->labels, yseq[t].c_str());
+  }
+  _inst.group = group;
+
+  // The instance is moved to the data set rather than copied.
+  int ret = crfsuite_data_append_move(data, &_inst);
+  crfsuite_instance_finish(&_inst);
+  if (ret != 0)
+  {
+    throw std::runtime_error("Out of memory.");
+  }
+}
+
 void NodeTrainer::message(const std::string &msg)
 {
   if (this->debug)
@@ -3,16 +3,49 @@
 
 #include <iostream>
 #include <functional>
+#include <vector>
 #include <crfsuite_api.hpp>
 
+#include "attribute_sequence.h"
+
 class NodeTrainer : public CRFSuite::Trainer
 {
 public:
   NodeTrainer(bool debug);
+
+  /**
+   * Ids of the given attributes in the training data, which are added to it
+   * when new. The ids are valid until the training data is cleared.
+   */
+  std::vector<int32_t> attributeIds(const CRFSuite::StringList &names);
+
+  /**
+   * The attributes of xseq by id, adding the new ones to the training data.
+   */
+  AttributeSequence resolve(const CRFSuite::ItemSequence &xseq);
+
+  using CRFSuite::Trainer::append;
+  void append(const AttributeSequence &xseq, const CRFSuite::StringList &yseq, int group);
+
+  /**
+   * Appends many sequences at once, after checking all of them (nothing is
+   * appended when one is invalid) and reserving their storage.
+   */
+  void append(const std::vector<AttributeSequence> &xseqs, const std::vector<CRFSuite::StringList> &yseqs, int group);
+
+  /**
+   * Throws std::invalid_argument when xseq cannot be appended with the labels
+   * yseq, e.g. to check a whole batch before resolving its attribute names.
+   */
+  void check(const AttributeSequence &xseq, const CRFSuite::StringList &yseq);
+
   virtual void message(const std::string &msg);
   virtual void progress(const int32_t iteration);
   std::function<void(const int32_t iteration)> progress_callback;
   bool debug = false;
+
+private:
+  void add(const AttributeSequence &xseq, const CRFSuite::StringList &yseq, int group);
 };
 
 #endif
\ No newline at end of file
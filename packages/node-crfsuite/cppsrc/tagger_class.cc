@@ -7,7 +7,6 @@ TaggerClass::TaggerClass(const Napi::CallbackInfo &info)
 {
   Napi::Env env = info.Env();
   Napi::HandleScope scope(env);
-  tagger = new CRFSuite::Tagger();
 }
 
 Napi::Object TaggerClass::Init(Napi::Env env, Napi::Object exports)
@@ -18,7 +17,14 @@ Napi::Object TaggerClass::Init(Napi::Env env, Napi::Object exports)
                                      InstanceMethod("close", &TaggerClass::Close),
                                      InstanceMethod("tag", &TaggerClass::Tag),
                                      InstanceMethod("get_labels", &TaggerClass::GetLabels),
-                                     InstanceMethod("marginal", &TaggerClass::Marginal)
+                                     InstanceMethod("marginal", &TaggerClass::Marginal),
+                                     InstanceMethod("tagAsync", &TaggerClass::TagAsync),
+                                     InstanceMethod("marginalAsync", &TaggerClass::MarginalAsync),
+                                     InstanceMethod("marginals", &TaggerClass::Marginals),
+                                     InstanceMethod("marginalsAsync", &TaggerClass::MarginalsAsync),
+                                     InstanceMethod("tagBatch", &TaggerClass::TagBatch),
+                                     InstanceMethod("marginalBatch", &TaggerClass::MarginalBatch),
+                                     InstanceMethod("getAttributeIds", &TaggerClass::GetAttributeIds)
 
                                     });
 
@@ -31,40 +37,81 @@ Napi::Object TaggerClass::Init(Napi::Env env, Napi::Object exports)
 
 Napi::Value TaggerClass::Open(const Napi::CallbackInfo &info)
 {
+  if (info.Length() > 0 && info[0].IsTypedArray() &&
+      info[0].As<Napi::TypedArray>().TypedArrayType() == napi_uint8_array)
+  {
+    // The model is read in place: the bytes must not be modified while it is opened.
+    Napi::Uint8Array data = info[0].As<Napi::Uint8Array>();
+    std::shared_ptr<Napi::ObjectReference> pin(new Napi::ObjectReference(Napi::Persistent(data.As<Napi::Object>())));
+    this->model = TaggerModel::open(data.Data(), data.ByteLength(), pin);
+    return Napi::Boolean::New(info.Env(), this->model != nullptr);
+  }
+
   if (info.Length() < 1 || !info[0].IsString())
   {
-    Napi::TypeError::New(info.Env(), "Path to model file is missing or invalid").ThrowAsJavaScriptException();
+    Napi::TypeError::New(info.Env(), "Path to model file or model buffer is missing or invalid").ThrowAsJavaScriptException();
+    return info.Env().Null();
   }
 
   Napi::String path = info[0].As<Napi::String>();
-  return Napi::Boolean::New(info.Env(), this->tagger->open(path.Utf8Value()));
+  this->model = TaggerModel::open(path.Utf8Value());
+  return Napi::Boolean::New(info.Env(), this->model != nullptr);
 }
 
 Napi::Value TaggerClass::Close(const Napi::CallbackInfo &info)
 {
-  this->tagger->close();
+  this->model.reset();
   return Napi::Boolean::New(info.Env(), true);
 }
 
-CRFSuite::ItemSequence TaggerClass::GetItems(const Napi::CallbackInfo &info, struct Error & err)
+bool TaggerClass::CheckOpened(Napi::Env env)
 {
-  Napi::Env env = info.Env();
-  Napi::HandleScope scope(env);
-
-  CRFSuite::ItemSequence items;
+  if (!this->model)
+  {
+    Napi::Error::New(env, "The tagger is not opened").ThrowAsJavaScriptException();
+    return false;
+  }
+  return true;
+}
 
+AttributeSequence TaggerClass::GetAttributes(const Napi::CallbackInfo &info, struct Error & err)
+{
   if (info.Length() < 1)
   {
     err.msg = "xseq is missing";
-    return items;
+    return AttributeSequence();
   }
-  else if (!info[0].IsArray())
+  return GetAttributes(info[0], err);
+}
+
+AttributeSequence TaggerClass::GetAttributes(Napi::Value value, struct Error & err)
+{
+  if (IsAttributeSequence(value))
+  {
+    return GetAttributeSequence(value, err.msg);
+  }
+
+  CRFSuite::ItemSequence items = GetItems(value, err);
+  if (err.msg != "") {
+    return AttributeSequence();
+  }
+  return this->model->resolve(items);
+}
+
+CRFSuite::ItemSequence TaggerClass::GetItems(Napi::Value value, struct Error & err)
+{
+  Napi::Env env = value.Env();
+  Napi::HandleScope scope(env);
+
+  CRFSuite::ItemSequence items;
+
+  if (!value.IsArray())
   {
     err.msg = "xseq must be an array of arrays";
     return items;
   }
 
-  Napi::Array xseq = info[0].As<Napi::Array>();
+  Napi::Array xseq = value.As<Napi::Array>();
 
   for (size_t i = 0; i < xseq.Length(); ++i)
   {
@@ -111,34 +158,33 @@ Napi::Value TaggerClass::Tag(const Napi::CallbackInfo &info)
   Napi::Env env = info.Env();
   Napi::HandleScope scope(env);
 
+  if (!CheckOpened(env)) {
+    return env.Null();
+  }
   struct Error err = {""};
-  CRFSuite::ItemSequence items = GetItems(info, err);
+  AttributeSequence xseq = GetAttributes(info, err);
   if (err.msg != "") {
     Napi::TypeError::New(env, err.msg).ThrowAsJavaScriptException();
     return env.Null();
   }
 
-  CRFSuite::StringList labels = this->tagger->tag(items);
-  double probability = this->tagger->probability(labels);
-
-  // Create a new empty array.
-  Napi::Array array = Napi::Array::New(env);
-  for (size_t i = 0; i < labels.size(); i++)
+  try
   {
-    Napi::String value = Napi::String::New(env, labels[i].c_str());
-    array.Set(i, value);
+    return TagResultToNapi(env, this->model->tag(xseq));
+  }
+  catch (const std::exception &e)
+  {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
   }
-  // output tuple
-  Napi::Object ret = Napi::Object::New(env);
-  ret.Set("probability", Napi::Number::New(env, probability));
-  ret.Set("result", array);
-
-  return ret;
 }
 
 Napi::Value TaggerClass::GetLabels(const Napi::CallbackInfo &info)
 {
-  CRFSuite::StringList list = this->tagger->labels();
+  if (!CheckOpened(info.Env())) {
+    return info.Env().Null();
+  }
+  const CRFSuite::StringList &list = this->model->labels();
 
   // Create a new empty array.
   Napi::Array result = Napi::Array::New(info.Env(), list.size());
@@ -153,31 +199,143 @@ Napi::Value TaggerClass::GetLabels(const Napi::CallbackInfo &info)
 }
 
 Napi::Value TaggerClass::Marginal(const Napi::CallbackInfo &info)
+{
+  return GetMarginal(info, false);
+}
+
+Napi::Value TaggerClass::Marginals(const Napi::CallbackInfo &info)
+{
+  return GetMarginal(info, true);
+}
+
+Napi::Value TaggerClass::GetMarginal(const Napi::CallbackInfo &info, bool dense)
 {
   Napi::Env env = info.Env();
   Napi::HandleScope scope(env);
 
+  if (!CheckOpened(env)) {
+    return env.Null();
+  }
+  struct Error err = {""};
+  AttributeSequence xseq = GetAttributes(info, err);
+  if (err.msg != "") {
+    Napi::TypeError::New(env, err.msg).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  try
+  {
+    std::vector<double> marginal = this->model->marginal(xseq);
+    return dense ? MarginalsToNapi(env, this->model->labels(), marginal)
+                 : MarginalToNapi(env, this->model->labels(), marginal);
+  }
+  catch (const std::exception &e)
+  {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+Napi::Value TaggerClass::Run(const Napi::CallbackInfo &info, TaggingWorker::Output output)
+{
+  Napi::Env env = info.Env();
+
+  if (!CheckOpened(env)) {
+    return env.Null();
+  }
   struct Error err = {""};
-  CRFSuite::ItemSequence items = this->GetItems(info, err);
+  AttributeSequence xseq = GetAttributes(info, err);
   if (err.msg != "") {
     Napi::TypeError::New(env, err.msg).ThrowAsJavaScriptException();
     return env.Null();
   }
 
-  this->tagger->set(items);
-  CRFSuite::StringList labels = this->tagger->labels();
-  Napi::Array array = Napi::Array::New(env);
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
 
-  for (size_t w = 0; w < items.size(); w++)
+  TaggingWorker *worker = new TaggingWorker(this->model, std::move(xseq), output, deferred);
+  worker->Queue();
+
+  return worker->deferred_.Promise();
+}
+
+Napi::Value TaggerClass::TagAsync(const Napi::CallbackInfo &info)
+{
+  return Run(info, TaggingWorker::TAG);
+}
+
+Napi::Value TaggerClass::MarginalAsync(const Napi::CallbackInfo &info)
+{
+  return Run(info, TaggingWorker::MARGINAL);
+}
+
+Napi::Value TaggerClass::MarginalsAsync(const Napi::CallbackInfo &info)
+{
+  return Run(info, TaggingWorker::MARGINALS);
+}
+
+Napi::Value TaggerClass::RunBatch(const Napi::CallbackInfo &info, bool marginal)
+{
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsArray())
   {
-    Napi::Object probs = Napi::Object::New(env);
-    for (size_t i = 0; i < labels.size(); i++)
-    {
-      double probability = this->tagger->marginal(labels[i], w);
-      probs.Set(labels[i].c_str(), Napi::Number::New(env, probability));
+    Napi::TypeError::New(env, "xseqs must be an array of xseq").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (!CheckOpened(env)) {
+    return env.Null();
+  }
+
+  Napi::Array napiXseqs = info[0].As<Napi::Array>();
+  std::vector<AttributeSequence> xseqs(napiXseqs.Length());
+  for (uint32_t i = 0; i < napiXseqs.Length(); i++)
+  {
+    struct Error err = {""};
+    xseqs[i] = this->GetAttributes(napiXseqs.Get(i), err);
+    if (err.msg != "") {
+      Napi::TypeError::New(env, err.msg).ThrowAsJavaScriptException();
+      return env.Null();
     }
-    array.Set(w, probs);
   }
 
-  return array;
+  int32_t nthreads = 1;
+  if (info.Length() > 1 && info[1].IsNumber())
+  {
+    nthreads = info[1].As<Napi::Number>().Int32Value();
+  }
+
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+
+  BatchTaggingWorker *worker = new BatchTaggingWorker(this->model, std::move(xseqs), nthreads, marginal, deferred);
+  worker->Queue();
+
+  return worker->deferred_.Promise();
+}
+
+Napi::Value TaggerClass::TagBatch(const Napi::CallbackInfo &info)
+{
+  return RunBatch(info, false);
+}
+
+Napi::Value TaggerClass::MarginalBatch(const Napi::CallbackInfo &info)
+{
+  return RunBatch(info, true);
+}
+
+Napi::Value TaggerClass::GetAttributeIds(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+
+  if (!CheckOpened(env)) {
+    return env.Null();
+  }
+  std::string err;
+  CRFSuite::StringList names = GetAttributeNames(info.Length() > 0 ? info[0] : env.Undefined(), err);
+  if (err != "") {
+    Napi::TypeError::New(env, err).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  return AttributeIdsToNapi(env, this->model->attributeIds(names));
 }
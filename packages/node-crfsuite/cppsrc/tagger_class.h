@@ -1,23 +1,20 @@
 #ifndef _TAGGER_CLASS_H_
 #define _TAGGER_CLASS_H_
 
+#include <memory>
 #include <napi.h>
 #include <crfsuite_api.hpp>
 
+#include "node_attributes.h"
+#include "tagger_model.h"
+#include "tagging_worker.h"
+
 class TaggerClass : public Napi::ObjectWrap<TaggerClass>
 {
 public:
   static Napi::Object Init(Napi::Env env, Napi::Object exports);
   explicit TaggerClass(const Napi::CallbackInfo &info);
 
-  /**
-   * Destructor
-   */
-  ~TaggerClass()
-  {
-    delete tagger;
-  }
-
 private:
   static Napi::FunctionReference constructor;
 
@@ -26,11 +23,26 @@ private:
   Napi::Value Tag(const Napi::CallbackInfo &info);
   Napi::Value GetLabels(const Napi::CallbackInfo &info);
   Napi::Value Marginal(const Napi::CallbackInfo &info);
+  Napi::Value TagAsync(const Napi::CallbackInfo &info);
+  Napi::Value MarginalAsync(const Napi::CallbackInfo &info);
+  Napi::Value Marginals(const Napi::CallbackInfo &info);
+  Napi::Value MarginalsAsync(const Napi::CallbackInfo &info);
+  Napi::Value TagBatch(const Napi::CallbackInfo &info);
+  Napi::Value MarginalBatch(const Napi::CallbackInfo &info);
+  Napi::Value GetAttributeIds(const Napi::CallbackInfo &info);
 
   struct Error { std::string msg; };
-  CRFSuite::ItemSequence GetItems(const Napi::CallbackInfo &info, struct Error & err);
-
-  CRFSuite::Tagger *tagger;
+  CRFSuite::ItemSequence GetItems(Napi::Value xseq, struct Error & err);
+  // xseq given by attribute names or ids, resolved against the opened model
+  AttributeSequence GetAttributes(const Napi::CallbackInfo &info, struct Error & err);
+  AttributeSequence GetAttributes(Napi::Value xseq, struct Error & err);
+  bool CheckOpened(Napi::Env env);
+  Napi::Value GetMarginal(const Napi::CallbackInfo &info, bool dense);
+  Napi::Value Run(const Napi::CallbackInfo &info, TaggingWorker::Output output);
+  Napi::Value RunBatch(const Napi::CallbackInfo &info, bool marginal);
+
+  // Shared with the pending async calls, released once the last one is done.
+  std::shared_ptr<TaggerModel> model;
 };
 
 #endif
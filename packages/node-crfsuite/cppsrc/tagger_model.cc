@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <thread>
+#include <crfsuite.h>
+#include "tagger_model.h"
+
+// Ceiling of the batch threads when the hardware concurrency is unknown.
+constexpr int32_t MAX_BATCH_THREADS = 64;
+
+std::shared_ptr<TaggerModel> TaggerModel::open(const std::string &filename)
+{
+  crfsuite_model_t *model = NULL;
+  if (crfsuite_create_instance_from_file(filename.c_str(), (void **)&model))
+  {
+    return nullptr;
+  }
+  return std::shared_ptr<TaggerModel>(new TaggerModel(model, nullptr));
+}
+
+std::shared_ptr<TaggerModel> TaggerModel::open(const void *data, size_t size, std::shared_ptr<void> owner)
+{
+  crfsuite_model_t *model = NULL;
+  if (crfsuite_create_instance_from_memory(data, size, (void **)&model))
+  {
+    return nullptr;
+  }
+  return std::shared_ptr<TaggerModel>(new TaggerModel(model, owner));
+}
+
+TaggerModel::TaggerModel(crfsuite_model_t *model, std::shared_ptr<void> owner)
+    : model_(model), attrs_(NULL), labelIds_(NULL), numAttrs_(0), owner_(owner)
+{
+  // The dictionaries are owned by the model, which does not count these references.
+  if (model_->get_attrs(model_, &attrs_) || model_->get_labels(model_, &labelIds_))
+  {
+    model_->release(model_);
+    throw std::runtime_error("Failed to obtain the dictionary interfaces of the model");
+  }
+  numAttrs_ = attrs_->num(attrs_);
+
+  for (int i = 0; i < labelIds_->num(labelIds_); ++i)
+  {
+    const char *label = NULL;
+    labelIds_->to_string(labelIds_, i, &label);
+    labels_.push_back(label != NULL ? label : "");
+    labelIds_->free(labelIds_, label);
+  }
+}
+
+TaggerModel::~TaggerModel()
+{
+  for (crfsuite_tagger_t *tagger : pool_)
+  {
+    tagger->release(tagger);
+  }
+  model_->release(model_);
+}
+
+TaggerModel::Context::Context(TaggerModel &model) : tagger(NULL), model_(model)
+{
+  {
+    std::lock_guard<std::mutex> lock(model_.mtx_);
+    if (!model_.pool_.empty())
+    {
+      tagger = model_.pool_.back();
+      model_.pool_.pop_back();
+      return;
+    }
+  }
+  if (model_.model_->get_tagger(model_.model_, &tagger))
+  {
+    throw std::runtime_error("Failed to obtain the tagger interface");
+  }
+}
+
+TaggerModel::Context::~Context()
+{
+  std::lock_guard<std::mutex> lock(model_.mtx_);
+  model_.pool_.push_back(tagger);
+}
+
+const CRFSuite::StringList &TaggerModel::labels() const
+{
+  return labels_;
+}
+
+std::vector<int32_t> TaggerModel::attributeIds(const CRFSuite::StringList &names)
+{
+  std::vector<int32_t> ids(names.size());
+  std::lock_guard<std::mutex> lock(cacheMtx_);
+  for (size_t i = 0; i < names.size(); ++i)
+  {
+    std::unordered_map<std::string, int32_t>::const_iterator it = attrIds_.find(names[i]);
+    if (it != attrIds_.end())
+    {
+      ids[i] = it->second;
+      continue;
+    }
+    ids[i] = attrs_->to_id(attrs_, names[i].c_str());
+    // Only known attributes are cached, the cache is bounded by the model.
+    if (0 <= ids[i])
+    {
+      attrIds_[names[i]] = ids[i];
+    }
+  }
+  return ids;
+}
+
+AttributeSequence TaggerModel::resolve(const CRFSuite::ItemSequence &xseq) const
+{
+  AttributeSequence result;
+  result.offsets.reserve(xseq.size() + 1);
+  result.offsets.push_back(0);
+  for (const CRFSuite::Item &item : xseq)
+  {
+    for (const CRFSuite::Attribute &attr : item)
+    {
+      int aid = attrs_->to_id(attrs_, attr.attr.c_str());
+      if (0 <= aid)
+      {
+        result.ids.push_back(aid);
+        result.weights.push_back(attr.value);
+      }
+    }
+    result.offsets.push_back((int32_t)result.ids.size());
+  }
+  return result;
+}
+
+void TaggerModel::set(crfsuite_tagger_t *tagger, const AttributeSequence &xseq)
+{
+  crfsuite_instance_t inst;
+  crfsuite_instance_init_n(&inst, xseq.size());
+  for (size_t t = 0; t < xseq.size(); ++t)
+  {
+    crfsuite_item_t *_item = &inst.items[t];
+    crfsuite_item_init(_item);
+    for (int32_t k = xseq.offsets[t]; k < xseq.offsets[t + 1]; ++k)
+    {
+      int32_t aid = xseq.ids[k];
+      if (0 <= aid && aid < numAttrs_)
+      {
+        crfsuite_attribute_t cont;
+        crfsuite_attribute_set(&cont, aid, xseq.weights.empty() ? 1. : xseq.weights[k]);
+        crfsuite_item_append_attribute(_item, &cont);
+      }
+    }
+  }
+
+  int ret = tagger->set(tagger, &inst);
+  crfsuite_instance_finish(&inst);
+  if (ret)
+  {
+    throw std::runtime_error("Failed to set the instance to the tagger.");
+  }
+}
+
+double TaggerModel::viterbi(crfsuite_tagger_t *tagger, const AttributeSequence &xseq, int32_t *path)
+{
+  if (xseq.size() == 0)
+  {
+    return 0.;
+  }
+
+  set(tagger, xseq);
+  floatval_t score, lognorm;
+  if (tagger->viterbi_lognorm(tagger, path, &score, &lognorm))
+  {
+    throw std::runtime_error("Failed to find the Viterbi path.");
+  }
+  return std::exp((double)(score - lognorm));
+}
+
+void TaggerModel::marginal(crfsuite_tagger_t *tagger, const AttributeSequence &xseq, double *probs)
+{
+  if (xseq.size() == 0)
+  {
+    return;
+  }
+
+  set(tagger, xseq);
+  if (tagger->marginals(tagger, probs))
+  {
+    throw std::runtime_error("Failed to compute the marginal probabilities.");
+  }
+}
+
+TaggerModel::TagResult TaggerModel::tag(const CRFSuite::ItemSequence &xseq)
+{
+  return tag(resolve(xseq));
+}
+
+TaggerModel::TagResult TaggerModel::tag(const AttributeSequence &xseq)
+{
+  TagResult result = {CRFSuite::StringList(), 0.};
+  std::vector<int32_t> path(xseq.size());
+  {
+    Context ctx(*this);
+    result.probability = viterbi(ctx.tagger, xseq, path.data());
+  }
+
+  result.labels.reserve(path.size());
+  for (int32_t l : path)
+  {
+    result.labels.push_back(labels_[l]);
+  }
+  return result;
+}
+
+std::vector<double> TaggerModel::marginal(const CRFSuite::ItemSequence &xseq)
+{
+  return marginal(resolve(xseq));
+}
+
+std::vector<double> TaggerModel::marginal(const AttributeSequence &xseq)
+{
+  std::vector<double> probs(xseq.size() * labels_.size());
+  Context ctx(*this);
+  marginal(ctx.tagger, xseq, probs.data());
+  return probs;
+}
+
+TaggerModel::BatchResult TaggerModel::makeBatch(const std::vector<AttributeSequence> &xseqs)
+{
+  BatchResult result;
+  result.offsets.resize(xseqs.size() + 1, 0);
+  for (size_t i = 0; i < xseqs.size(); ++i)
+  {
+    result.offsets[i + 1] = result.offsets[i] + (int32_t)xseqs[i].size();
+  }
+  return result;
+}
+
+void TaggerModel::forEach(size_t count, int32_t nthreads, const std::function<void(crfsuite_tagger_t *, size_t)> &run)
+{
+  // Every thread leases a tagger that the pool keeps, so do not run more
+  // threads than the machine does.
+  int32_t ceiling = (int32_t)std::thread::hardware_concurrency();
+  if (ceiling == 0)
+  {
+    ceiling = MAX_BATCH_THREADS;
+  }
+  size_t n = std::max<size_t>(1, std::min<size_t>(std::min(std::max(nthreads, 1), ceiling), count));
+  std::vector<std::exception_ptr> errors(n);
+  auto runSlice = [&](size_t k) {
+    try
+    {
+      Context ctx(*this);
+      for (size_t i = count * k / n; i < count * (k + 1) / n; ++i)
+      {
+        run(ctx.tagger, i);
+      }
+    }
+    catch (...)
+    {
+      errors[k] = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t k = 1; k < n; ++k)
+  {
+    threads.push_back(std::thread(runSlice, k));
+  }
+  runSlice(0);
+  for (std::thread &thread : threads)
+  {
+    thread.join();
+  }
+  for (const std::exception_ptr &error : errors)
+  {
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+TaggerModel::BatchResult TaggerModel::tagBatch(const std::vector<AttributeSequence> &xseqs, int32_t nthreads)
+{
+  BatchResult result = makeBatch(xseqs);
+  result.ids.resize(result.offsets.back());
+  result.values.resize(xseqs.size());
+  forEach(xseqs.size(), nthreads, [&](crfsuite_tagger_t *tagger, size_t i) {
+    result.values[i] = viterbi(tagger, xseqs[i], result.ids.data() + result.offsets[i]);
+  });
+  return result;
+}
+
+TaggerModel::BatchResult TaggerModel::marginalBatch(const std::vector<AttributeSequence> &xseqs, int32_t nthreads)
+{
+  const size_t L = labels_.size();
+  BatchResult result = makeBatch(xseqs);
+  result.values.resize(result.offsets.back() * L);
+  forEach(xseqs.size(), nthreads, [&](crfsuite_tagger_t *tagger, size_t i) {
+    marginal(tagger, xseqs[i], result.values.data() + result.offsets[i] * L);
+  });
+  return result;
+}
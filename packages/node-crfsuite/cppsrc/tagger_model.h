@@ -0,0 +1,120 @@
+#ifndef _TAGGER_MODEL_H_
+#define _TAGGER_MODEL_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <crfsuite_api.hpp>
+
+#include "attribute_sequence.h"
+
+/**
+ * An opened CRF model, shared by every thread tagging with it.
+ *
+ * The crfsuite model is only read once opened. The scratch space of a tagging
+ * (a crfsuite tagger and its context) is taken from a pool instead, so that
+ * concurrent calls each get their own context, which the next calls reuse.
+ */
+class TaggerModel
+{
+public:
+  struct TagResult
+  {
+    CRFSuite::StringList labels;
+    double probability;
+  };
+
+  /**
+   * Results of many sequences packed in flat arrays. The positions of
+   * sequence i are numbered [offsets[i], offsets[i + 1]) across the batch.
+   */
+  struct BatchResult
+  {
+    std::vector<int32_t> offsets;
+    // tagBatch: label id of every position
+    std::vector<int32_t> ids;
+    // tagBatch: path probability of every sequence
+    // marginalBatch: marginal of label l at position p in [p * L + l]
+    std::vector<double> values;
+  };
+
+  /**
+   * Returns nullptr when the model cannot be opened. A model opened from
+   * memory reads the bytes in place, owner keeps them alive as long as the model.
+   */
+  static std::shared_ptr<TaggerModel> open(const std::string &filename);
+  static std::shared_ptr<TaggerModel> open(const void *data, size_t size, std::shared_ptr<void> owner);
+
+  ~TaggerModel();
+
+  const CRFSuite::StringList &labels() const;
+
+  /**
+   * Ids of the given attributes in this model, -1 for the unknown ones.
+   * The ids of known attributes are cached.
+   */
+  std::vector<int32_t> attributeIds(const CRFSuite::StringList &names);
+
+  /**
+   * The attributes of xseq by id, to tag the same sequence without looking up
+   * its attributes again.
+   */
+  AttributeSequence resolve(const CRFSuite::ItemSequence &xseq) const;
+
+  TagResult tag(const CRFSuite::ItemSequence &xseq);
+  TagResult tag(const AttributeSequence &xseq);
+
+  /**
+   * Marginal probabilities of every label at every position, the one of label
+   * l (by label id) at position t in [t * L + l].
+   */
+  std::vector<double> marginal(const CRFSuite::ItemSequence &xseq);
+  std::vector<double> marginal(const AttributeSequence &xseq);
+
+  /**
+   * Same as tag and marginal over many sequences, split in contiguous slices
+   * across nthreads threads. Each thread reuses one context for its slice.
+   */
+  BatchResult tagBatch(const std::vector<AttributeSequence> &xseqs, int32_t nthreads);
+  BatchResult marginalBatch(const std::vector<AttributeSequence> &xseqs, int32_t nthreads);
+
+private:
+  // A tagger leased from the pool for the duration of a call.
+  class Context
+  {
+  public:
+    explicit Context(TaggerModel &model);
+    ~Context();
+    crfsuite_tagger_t *tagger;
+
+  private:
+    TaggerModel &model_;
+  };
+
+  explicit TaggerModel(crfsuite_model_t *model, std::shared_ptr<void> owner);
+
+  void set(crfsuite_tagger_t *tagger, const AttributeSequence &xseq);
+  double viterbi(crfsuite_tagger_t *tagger, const AttributeSequence &xseq, int32_t *path);
+  void marginal(crfsuite_tagger_t *tagger, const AttributeSequence &xseq, double *probs);
+  static BatchResult makeBatch(const std::vector<AttributeSequence> &xseqs);
+  void forEach(size_t count, int32_t nthreads, const std::function<void(crfsuite_tagger_t *, size_t)> &run);
+
+  crfsuite_model_t *model_;
+  crfsuite_dictionary_t *attrs_;
+  crfsuite_dictionary_t *labelIds_;
+  int32_t numAttrs_;
+  CRFSuite::StringList labels_;
+  std::shared_ptr<void> owner_;
+
+  std::mutex cacheMtx_;
+  std::unordered_map<std::string, int32_t> attrIds_;
+
+  std::mutex mtx_;
+  std::vector<crfsuite_tagger_t *> pool_;
+};
+
+#endif
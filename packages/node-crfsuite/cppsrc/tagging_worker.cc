@@ -0,0 +1,157 @@
+#include "tagging_worker.h"
+
+#include <string.h>
+
+Napi::Value TagResultToNapi(Napi::Env env, const TaggerModel::TagResult &result)
+{
+  Napi::Array array = Napi::Array::New(env, result.labels.size());
+  for (size_t i = 0; i < result.labels.size(); i++)
+  {
+    array.Set(i, Napi::String::New(env, result.labels[i]));
+  }
+
+  // output tuple
+  Napi::Object ret = Napi::Object::New(env);
+  ret.Set("probability", Napi::Number::New(env, result.probability));
+  ret.Set("result", array);
+  return ret;
+}
+
+Napi::Value LabelsToNapi(Napi::Env env, const CRFSuite::StringList &labels)
+{
+  Napi::Array array = Napi::Array::New(env, labels.size());
+  for (size_t i = 0; i < labels.size(); i++)
+  {
+    array.Set(i, Napi::String::New(env, labels[i]));
+  }
+  return array;
+}
+
+Napi::Value MarginalToNapi(Napi::Env env, const CRFSuite::StringList &labels, const std::vector<double> &marginal)
+{
+  const size_t L = labels.size();
+  const size_t T = L ? marginal.size() / L : 0;
+  Napi::Array array = Napi::Array::New(env, T);
+  for (size_t w = 0; w < T; w++)
+  {
+    Napi::Object probs = Napi::Object::New(env);
+    for (size_t i = 0; i < L; i++)
+    {
+      probs.Set(labels[i], Napi::Number::New(env, marginal[w * L + i]));
+    }
+    array.Set(w, probs);
+  }
+  return array;
+}
+
+Napi::Value MarginalsToNapi(Napi::Env env, const CRFSuite::StringList &labels, const std::vector<double> &marginal)
+{
+  Napi::Float64Array values = Napi::Float64Array::New(env, marginal.size());
+  memcpy(values.Data(), marginal.data(), marginal.size() * sizeof(double));
+
+  Napi::Object ret = Napi::Object::New(env);
+  ret.Set("labels", LabelsToNapi(env, labels));
+  ret.Set("marginals", values);
+  return ret;
+}
+
+TaggingWorker::TaggingWorker(std::shared_ptr<TaggerModel> model, AttributeSequence xseq, Output output,
+                             Napi::Promise::Deferred deferred)
+    : Napi::AsyncWorker(deferred.Env()), deferred_(deferred), model_(model), xseq_(std::move(xseq)), output_(output)
+{
+}
+
+void TaggingWorker::Execute()
+{
+  try
+  {
+    if (output_ != TAG)
+    {
+      marginalResult_ = model_->marginal(xseq_);
+    }
+    else
+    {
+      tagResult_ = model_->tag(xseq_);
+    }
+  }
+  catch (const std::exception &e)
+  {
+    SetError(e.what());
+  }
+}
+
+void TaggingWorker::OnOK()
+{
+  Napi::Env env = Env();
+  Napi::HandleScope scope(env);
+  if (output_ == MARGINALS)
+  {
+    deferred_.Resolve(MarginalsToNapi(env, model_->labels(), marginalResult_));
+  }
+  else if (output_ == MARGINAL)
+  {
+    deferred_.Resolve(MarginalToNapi(env, model_->labels(), marginalResult_));
+  }
+  else
+  {
+    deferred_.Resolve(TagResultToNapi(env, tagResult_));
+  }
+}
+
+void TaggingWorker::OnError(const Napi::Error &e)
+{
+  Napi::HandleScope scope(Env());
+  deferred_.Reject(e.Value());
+}
+
+BatchTaggingWorker::BatchTaggingWorker(std::shared_ptr<TaggerModel> model, std::vector<AttributeSequence> xseqs,
+                                       int32_t nthreads, bool marginal, Napi::Promise::Deferred deferred)
+    : Napi::AsyncWorker(deferred.Env()), deferred_(deferred), model_(model), xseqs_(std::move(xseqs)),
+      nthreads_(nthreads), marginal_(marginal)
+{
+}
+
+void BatchTaggingWorker::Execute()
+{
+  try
+  {
+    result_ = marginal_ ? model_->marginalBatch(xseqs_, nthreads_) : model_->tagBatch(xseqs_, nthreads_);
+  }
+  catch (const std::exception &e)
+  {
+    SetError(e.what());
+  }
+}
+
+void BatchTaggingWorker::OnOK()
+{
+  Napi::Env env = Env();
+  Napi::HandleScope scope(env);
+
+  Napi::Int32Array offsets = Napi::Int32Array::New(env, result_.offsets.size());
+  memcpy(offsets.Data(), result_.offsets.data(), result_.offsets.size() * sizeof(int32_t));
+  Napi::Float64Array values = Napi::Float64Array::New(env, result_.values.size());
+  memcpy(values.Data(), result_.values.data(), result_.values.size() * sizeof(double));
+
+  Napi::Object ret = Napi::Object::New(env);
+  ret.Set("labels", LabelsToNapi(env, model_->labels()));
+  ret.Set("offsets", offsets);
+  if (marginal_)
+  {
+    ret.Set("marginals", values);
+  }
+  else
+  {
+    Napi::Int32Array ids = Napi::Int32Array::New(env, result_.ids.size());
+    memcpy(ids.Data(), result_.ids.data(), result_.ids.size() * sizeof(int32_t));
+    ret.Set("ids", ids);
+    ret.Set("probabilities", values);
+  }
+  deferred_.Resolve(ret);
+}
+
+void BatchTaggingWorker::OnError(const Napi::Error &e)
+{
+  Napi::HandleScope scope(Env());
+  deferred_.Reject(e.Value());
+}
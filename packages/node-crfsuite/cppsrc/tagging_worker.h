@@ -0,0 +1,77 @@
+#ifndef _TAGGING_WORKER_H_
+#define _TAGGING_WORKER_H_
+
+#include <memory>
+#include <napi.h>
+#include <crfsuite_api.hpp>
+
+#include "tagger_model.h"
+
+Napi::Value TagResultToNapi(Napi::Env env, const TaggerModel::TagResult &result);
+Napi::Value LabelsToNapi(Napi::Env env, const CRFSuite::StringList &labels);
+// one object per position, mapping every label to its marginal
+Napi::Value MarginalToNapi(Napi::Env env, const CRFSuite::StringList &labels, const std::vector<double> &marginal);
+// { labels, marginals: Float64Array } with the marginals of a position on each row
+Napi::Value MarginalsToNapi(Napi::Env env, const CRFSuite::StringList &labels, const std::vector<double> &marginal);
+
+/**
+ * Tags (or computes the marginals of) a sequence on the libuv thread pool.
+ * The worker shares the model with its tagger, so it stays usable even if
+ * the tagger is closed or reopened meanwhile.
+ */
+class TaggingWorker : public Napi::AsyncWorker
+{
+public:
+  enum Output
+  {
+    TAG,
+    MARGINAL,
+    MARGINALS
+  };
+
+  TaggingWorker(std::shared_ptr<TaggerModel> model, AttributeSequence xseq, Output output,
+                Napi::Promise::Deferred deferred);
+
+  void Execute();
+
+  void OnOK();
+
+  void OnError(const Napi::Error &e);
+
+  Napi::Promise::Deferred deferred_;
+
+private:
+  std::shared_ptr<TaggerModel> model_;
+  AttributeSequence xseq_;
+  Output output_;
+  TaggerModel::TagResult tagResult_;
+  std::vector<double> marginalResult_;
+};
+
+/**
+ * Tags (or computes the marginals of) many sequences on a libuv thread,
+ * itself splitting them across nthreads threads.
+ */
+class BatchTaggingWorker : public Napi::AsyncWorker
+{
+public:
+  BatchTaggingWorker(std::shared_ptr<TaggerModel> model, std::vector<AttributeSequence> xseqs,
+                     int32_t nthreads, bool marginal, Napi::Promise::Deferred deferred);
+
+  void Execute();
+
+  void OnOK();
+
+  void OnError(const Napi::Error &e);
+
+  Napi::Promise::Deferred deferred_;
+
+private:
+  std::shared_ptr<TaggerModel> model_;
+  std::vector<AttributeSequence> xseqs_;
+  int32_t nthreads_;
+  bool marginal_;
+  TaggerModel::BatchResult result_;
+};
+
+#endif
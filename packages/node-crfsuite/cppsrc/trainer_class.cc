@@ -1,4 +1,5 @@
 #include <iostream>
+#include <sstream>
 #include "trainer_class.h"
 
 Napi::FunctionReference TrainerClass::constructor;
@@ -11,6 +12,8 @@ Napi::Object TrainerClass::Init(Napi::Env env, Napi::Object exports)
                                      InstanceMethod("get_params", &TrainerClass::GetParams),
                                      InstanceMethod("set_params", &TrainerClass::SetParams),
                                      InstanceMethod("append", &TrainerClass::Append),
+                                     InstanceMethod("append_batch", &TrainerClass::AppendBatch),
+                                     InstanceMethod("get_attribute_ids", &TrainerClass::GetAttributeIds),
                                      InstanceMethod("train", &TrainerClass::Train),
                                      InstanceMethod("train_async", &TrainerClass::TrainAsync)});
 
@@ -87,40 +90,24 @@ void TrainerClass::SetParams(const Napi::CallbackInfo &info)
   }
 }
 
-void TrainerClass::Append(const Napi::CallbackInfo &info)
+static CRFSuite::ItemSequence GetItems(Napi::Value value, std::string &err)
 {
-  if (info.Length() < 2)
-  {
-    Napi::TypeError::New(info.Env(), "Invalid number of arguments").ThrowAsJavaScriptException();
-  }
-
-  if (!info[0].IsArray())
-  {
-    Napi::TypeError::New(info.Env(), "xseq (training data) argument must be an array of arrays").ThrowAsJavaScriptException();
-  }
-
-  if (!info[1].IsArray())
-  {
-    Napi::TypeError::New(info.Env(), "yseq (labels) argument must be an array").ThrowAsJavaScriptException();
-  }
-
-  Napi::Array xseq = info[0].As<Napi::Array>(); // Local<Array>::Cast(args[0]);
-  Napi::Array yseq = info[1].As<Napi::Array>(); // Local<Array>::Cast(args[1]);
+  CRFSuite::ItemSequence items;
 
-  if (xseq.Length() != yseq.Length())
+  if (!value.IsArray())
   {
-    Napi::TypeError::New(info.Env(), "xseq and yseq must be of same size").ThrowAsJavaScriptException();
+    err = "xseq (training data) argument must be an array of arrays";
+    return items;
   }
 
-  CRFSuite::ItemSequence items;
-  CRFSuite::StringList labels;
-
+  Napi::Array xseq = value.As<Napi::Array>();
   for (size_t i = 0; i < xseq.Length(); ++i)
   {
     Napi::Value val = xseq.Get(i);
     if (!val.IsArray())
     {
-      Napi::TypeError::New(info.Env(), "xseq (training data) argument must be an array of arrays").ThrowAsJavaScriptException();
+      err = "xseq (training data) argument must be an array of arrays";
+      return items;
     }
 
     Napi::Array xxseq = val.As<Napi::Array>();
@@ -139,23 +126,67 @@ void TrainerClass::Append(const Napi::CallbackInfo &info)
         // weight provided
         double weight = atof(key.substr(pos + 1).c_str());
         std::string name = key.substr(0, pos);
-        // std::cout << "Weight of " << name << " is " << weight << " and pos " << pos << std::endl;
         item.push_back(CRFSuite::Attribute(name, weight));
       }
       else
       {
         // no weight
-        // std::cout << "NONE FOR  " << key << " pos is " << pos << std::endl;
         item.push_back(CRFSuite::Attribute(key));
       }
     }
     items.push_back(item);
   }
+  return items;
+}
+
+static CRFSuite::StringList GetLabels(Napi::Value value, std::string &err)
+{
+  CRFSuite::StringList labels;
 
+  if (!value.IsArray())
+  {
+    err = "yseq (labels) argument must be an array";
+    return labels;
+  }
+
+  Napi::Array yseq = value.As<Napi::Array>();
   for (size_t i = 0; i < yseq.Length(); ++i)
   {
-    Napi::String attrName = yseq.Get(i).ToString();
-    labels.push_back(attrName.Utf8Value());
+    labels.push_back(yseq.Get(i).ToString().Utf8Value());
+  }
+  return labels;
+}
+
+void TrainerClass::Append(const Napi::CallbackInfo &info)
+{
+  if (info.Length() < 2)
+  {
+    Napi::TypeError::New(info.Env(), "Invalid number of arguments").ThrowAsJavaScriptException();
+    return;
+  }
+
+  if (IsAttributeSequence(info[0]))
+  {
+    return AppendAttributes(info);
+  }
+
+  std::string err;
+  CRFSuite::ItemSequence items = GetItems(info[0], err);
+  CRFSuite::StringList labels;
+  if (err == "")
+  {
+    labels = GetLabels(info[1], err);
+  }
+  if (err != "")
+  {
+    Napi::TypeError::New(info.Env(), err).ThrowAsJavaScriptException();
+    return;
+  }
+
+  if (items.size() != labels.size())
+  {
+    Napi::TypeError::New(info.Env(), "xseq and yseq must be of same size").ThrowAsJavaScriptException();
+    return;
   }
 
   try
@@ -172,6 +203,139 @@ void TrainerClass::Append(const Napi::CallbackInfo &info)
   }
 }
 
+void TrainerClass::AppendAttributes(const Napi::CallbackInfo &info)
+{
+  std::string err;
+  AttributeSequence xseq = GetAttributeSequence(info[0], err);
+  if (err != "")
+  {
+    Napi::TypeError::New(info.Env(), err).ThrowAsJavaScriptException();
+    return;
+  }
+
+  CRFSuite::StringList labels = GetLabels(info[1], err);
+  if (err != "")
+  {
+    Napi::TypeError::New(info.Env(), err).ThrowAsJavaScriptException();
+    return;
+  }
+
+  try
+  {
+    this->trainer->append(xseq, labels, 0);
+  }
+  catch (std::invalid_argument &e)
+  {
+    Napi::TypeError::New(info.Env(), e.what()).ThrowAsJavaScriptException();
+  }
+  catch (std::runtime_error &e)
+  {
+    Napi::TypeError::New(info.Env(), "Out of memory").ThrowAsJavaScriptException();
+  }
+}
+
+void TrainerClass::AppendBatch(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (info.Length() < 2 || !info[0].IsArray() || !info[1].IsArray())
+  {
+    Napi::TypeError::New(env, "xseqs and yseqs must be arrays of sequences").ThrowAsJavaScriptException();
+    return;
+  }
+
+  Napi::Array napiXseqs = info[0].As<Napi::Array>();
+  Napi::Array napiYseqs = info[1].As<Napi::Array>();
+  if (napiXseqs.Length() != napiYseqs.Length())
+  {
+    Napi::TypeError::New(env, "xseqs and yseqs must be of same size").ThrowAsJavaScriptException();
+    return;
+  }
+
+  std::vector<AttributeSequence> xseqs(napiXseqs.Length());
+  std::vector<CRFSuite::ItemSequence> items(napiXseqs.Length());
+  std::vector<bool> named(napiXseqs.Length(), false);
+  std::vector<CRFSuite::StringList> yseqs(napiYseqs.Length());
+  try
+  {
+    // Every sequence is checked before the attribute names of any are added
+    // to the training data, so that a rejected batch leaves it unchanged.
+    for (uint32_t i = 0; i < napiXseqs.Length(); ++i)
+    {
+      std::string err;
+      Napi::Value xseq = napiXseqs.Get(i);
+      yseqs[i] = GetLabels(napiYseqs.Get(i), err);
+      if (err == "")
+      {
+        if (IsAttributeSequence(xseq))
+        {
+          xseqs[i] = GetAttributeSequence(xseq, err);
+        }
+        else
+        {
+          items[i] = GetItems(xseq, err);
+          named[i] = true;
+        }
+      }
+      if (err != "")
+      {
+        Napi::TypeError::New(env, err).ThrowAsJavaScriptException();
+        return;
+      }
+
+      if (!named[i])
+      {
+        this->trainer->check(xseqs[i], yseqs[i]);
+      }
+      else if (items[i].size() != yseqs[i].size())
+      {
+        std::stringstream ss;
+        ss << "The numbers of items and labels differ: |x| = " << items[i].size() << ", |y| = " << yseqs[i].size();
+        throw std::invalid_argument(ss.str());
+      }
+    }
+
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+      if (named[i])
+      {
+        xseqs[i] = this->trainer->resolve(items[i]);
+      }
+    }
+
+    this->trainer->append(xseqs, yseqs, 0);
+  }
+  catch (std::invalid_argument &e)
+  {
+    Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+  }
+  catch (std::runtime_error &e)
+  {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+  }
+}
+
+Napi::Value TrainerClass::GetAttributeIds(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  std::string err;
+  CRFSuite::StringList names = GetAttributeNames(info.Length() > 0 ? info[0] : env.Undefined(), err);
+  if (err != "")
+  {
+    Napi::TypeError::New(env, err).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  try
+  {
+    return AttributeIdsToNapi(env, this->trainer->attributeIds(names));
+  }
+  catch (std::runtime_error &e)
+  {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
 Napi::Value TrainerClass::Train(const Napi::CallbackInfo &info)
 {
   Napi::Env env = info.Env();
@@ -2,6 +2,7 @@
 #define _TRAINER_CLASS_H_
 
 #include <napi.h>
+#include "node_attributes.h"
 #include "node_trainer.h"
 #include "training_worker.h"
 
@@ -28,6 +29,9 @@ private:
   Napi::Value GetParams(const Napi::CallbackInfo &info);
   void SetParams(const Napi::CallbackInfo &info);
   void Append(const Napi::CallbackInfo &info);
+  void AppendAttributes(const Napi::CallbackInfo &info);
+  void AppendBatch(const Napi::CallbackInfo &info);
+  Napi::Value GetAttributeIds(const Napi::CallbackInfo &info);
   Napi::Value Train(const Napi::CallbackInfo &info);
   Napi::Value TrainAsync(const Napi::CallbackInfo &info);
   Napi::Value Test(const Napi::CallbackInfo &info);
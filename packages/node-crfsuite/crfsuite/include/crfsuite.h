@@ -518,6 +518,35 @@ struct tag_crfsuite_tagger {
      *  @return int         The status code.
      */
     int (*marginal_path)(crfsuite_tagger_t *tagger, const int *path, int begin, int end, floatval_t *ptr_prob);
+
+    /**
+     * Find the Viterbi label sequence and the log of the partition factor.
+     *  This function computes both in a single pass over the items, so that
+     *  the probability of the Viterbi path is exp(*ptr_score - *ptr_norm).
+     *  @param  tagger      The pointer to this tagger instance.
+     *  @param  labels      The label array that receives the Viterbi label
+     *                      sequence. The number of elements in the array must
+     *                      be no smaller than the number of item.
+     *  @param  ptr_score   The pointer to a float variable that receives the
+     *                      score of the Viterbi label sequence.
+     *  @param  ptr_norm    The pointer to a float variable that receives the
+     *                      logarithm of the partition factor.
+     *  @return int         The status code.
+     */
+    int (*viterbi_lognorm)(crfsuite_tagger_t* tagger, int *labels, floatval_t *ptr_score, floatval_t *ptr_norm);
+
+    /**
+     * Compute the marginal probabilities of all the labels at all the positions.
+     *  This function runs the forward-backward algorithm once, and stores
+     *  P(y_t = l | x) at probs[t * L + l], L being the number of labels.
+     *  @param  tagger      The pointer to this tagger instance.
+     *  @param  probs       The array that receives the marginal probabilities.
+     *                      The number of elements in the array must be no
+     *                      smaller than the number of items times the number
+     *                      of labels.
+     *  @return int         The status code.
+     */
+    int (*marginals)(crfsuite_tagger_t* tagger, floatval_t *probs);
 };
 
 /**
@@ -990,6 +1019,24 @@ void crfsuite_data_swap(crfsuite_data_t* x, crfsuite_data_t* y);
  */
 int  crfsuite_data_append(crfsuite_data_t* data, const crfsuite_instance_t* inst);
 
+/**
+ * Reserve the storage of instances to be appended to the dataset structure.
+ *  @param  data        The pointer to crfsuite_data_t.
+ *  @param  n           The number of instances to be appended.
+ *  @return int         \c 0 if successful, \c -1 otherwise.
+ */
+int  crfsuite_data_reserve(crfsuite_data_t* data, int n);
+
+/**
+ * Append an instance to the dataset structure without copying it.
+ *  The dataset takes over the items and labels of the instance, which is left
+ *  empty. An empty instance is not appended, and is still owned by the caller.
+ *  @param  data        The pointer to crfsuite_data_t.
+ *  @param  inst        The instance to be moved to the dataset.
+ *  @return int         \c 0 if successful, \c -1 otherwise.
+ */
+int  crfsuite_data_append_move(crfsuite_data_t* data, crfsuite_instance_t* inst);
+
 /**
  * Obtain the maximum length of the instances in the dataset.
  *  @param  data        The pointer to crfsuite_data_t.
@@ -141,8 +141,11 @@ void Trainer::append(const ItemSequence& xseq, const StringList& yseq, int group
     }
     _inst.group = group;
 
-    // Append the instance to the training set.
-    crfsuite_data_append(data, &_inst);
+    // Move the instance to the training set.
+    if (crfsuite_data_append_move(data, &_inst) != 0) {
+        crfsuite_instance_finish(&_inst);
+        throw std::runtime_error("Out of memory.");
+    }
 
     // Finish the instance.
     crfsuite_instance_finish(&_inst);
@@ -208,10 +208,12 @@ void crf1dc_alpha_score(crf1d_context_t* ctx);
 void crf1dc_beta_score(crf1d_context_t* ctx);
 void crf1dc_marginals(crf1d_context_t* ctx);
 floatval_t crf1dc_marginal_point(crf1d_context_t *ctx, int l, int t);
+void crf1dc_marginal_points(crf1d_context_t *ctx, floatval_t *probs);
 floatval_t crf1dc_marginal_path(crf1d_context_t *ctx, const int *path, int begin, int end);
 floatval_t crf1dc_score(crf1d_context_t* ctx, const int *labels);
 floatval_t crf1dc_lognorm(crf1d_context_t* ctx);
 floatval_t crf1dc_viterbi(crf1d_context_t* ctx, int *labels);
+floatval_t crf1dc_viterbi_lognorm(crf1d_context_t* ctx, int *labels);
 void crf1dc_debug_context(FILE *fp);
 
 /** @} */
@@ -346,6 +348,8 @@ int crf1dm_get_labelref(crf1dm_t* model, int lid, feature_refs_t* ref);
 int crf1dm_get_attrref(crf1dm_t* model, int aid, feature_refs_t* ref);
 int crf1dm_get_featureid(feature_refs_t* ref, int i);
 int crf1dm_get_feature(crf1dm_t* model, int fid, crf1dm_feature_t* f);
+int crf1dm_get_state_features(crf1dm_t* model, int aid, const int** labels, const floatval_t** weights);
+const floatval_t* crf1dm_get_transitions(crf1dm_t* model);
 void crf1dm_dump(crf1dm_t* model, FILE *fp);
 
 /** @} */
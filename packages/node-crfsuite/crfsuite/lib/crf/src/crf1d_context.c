@@ -172,7 +172,7 @@ void crf1dc_exp_state(crf1d_context_t* ctx)
     const int L = ctx->num_labels;
 
     veccopy(ctx->exp_state, ctx->state, L * T);
-    vecexp(ctx->exp_state, L * T);
+    vecexp_n(ctx->exp_state, L * T);
 }
 
 void crf1dc_exp_transition(crf1d_context_t* ctx)
@@ -180,15 +180,15 @@ void crf1dc_exp_transition(crf1d_context_t* ctx)
     const int L = ctx->num_labels;
 
     veccopy(ctx->exp_trans, ctx->trans, L * L);
-    vecexp(ctx->exp_trans, L * L);
+    vecexp_n(ctx->exp_trans, L * L);
 }
 
 void crf1dc_alpha_score(crf1d_context_t* ctx)
 {
-    int i, t;
+    int t;
     floatval_t sum, *cur = NULL;
     floatval_t *scale = &ctx->scale_factor[0];
-    const floatval_t *prev = NULL, *trans = NULL, *state = NULL;
+    const floatval_t *prev = NULL, *state = NULL;
     const int T = ctx->num_items;
     const int L = ctx->num_labels;
 
@@ -211,11 +211,7 @@ void crf1dc_alpha_score(crf1d_context_t* ctx)
         cur = ALPHA_SCORE(ctx, t);
         state = EXP_STATE_SCORE(ctx, t);
 
-        veczero(cur, L);
-        for (i = 0;i < L;++i) {
-            trans = EXP_TRANS_SCORE(ctx, i);
-            vecaadd(cur, prev[i], trans, L);
-        }
+        vecmatvec_t(cur, prev, EXP_TRANS_SCORE(ctx, 0), L);
         vecmul(cur, state, L);
         sum = vecsum(cur, L);
         *scale = (sum != 0.) ? 1. / sum : 1.;
@@ -232,10 +228,10 @@ void crf1dc_alpha_score(crf1d_context_t* ctx)
 
 void crf1dc_beta_score(crf1d_context_t* ctx)
 {
-    int i, t;
+    int t;
     floatval_t *cur = NULL;
     floatval_t *row = ctx->row;
-    const floatval_t *next = NULL, *state = NULL, *trans = NULL;
+    const floatval_t *next = NULL, *state = NULL;
     const int T = ctx->num_items;
     const int L = ctx->num_labels;
     const floatval_t *scale = &ctx->scale_factor[T-1];
@@ -255,10 +251,7 @@ void crf1dc_beta_score(crf1d_context_t* ctx)
         vecmul(row, state, L);
 
         /* Compute the beta score at (t, i). */
-        for (i = 0;i < L;++i) {
-            trans = EXP_TRANS_SCORE(ctx, i);
-            cur[i] = vecdot(trans, row, L);
-        }
+        vecmatvec(cur, EXP_TRANS_SCORE(ctx, 0), row, L);
         vecscale(cur, *scale, L);
         --scale;
     }
@@ -266,7 +259,7 @@ void crf1dc_beta_score(crf1d_context_t* ctx)
 
 void crf1dc_marginals(crf1d_context_t* ctx)
 {
-    int i, j, t;
+    int t;
     const int T = ctx->num_items;
     const int L = ctx->num_labels;
 
@@ -303,13 +296,7 @@ void crf1dc_marginals(crf1d_context_t* ctx)
         veccopy(row, bwd, L);
         vecmul(row, state, L);
 
-        for (i = 0;i < L;++i) {
-            floatval_t *edge = EXP_TRANS_SCORE(ctx, i);
-            floatval_t *prob = TRANS_MEXP(ctx, i);
-            for (j = 0;j < L;++j) {
-                prob[j] += fwd[i] * edge[j] * row[j];
-            }
-        }
+        vecmataadd(TRANS_MEXP(ctx, 0), fwd, EXP_TRANS_SCORE(ctx, 0), row, L);
     }
 }
 
@@ -320,6 +307,26 @@ floatval_t crf1dc_marginal_point(crf1d_context_t *ctx, int l, int t)
     return fwd[l] * bwd[l] / ctx->scale_factor[t];
 }
 
+void crf1dc_marginal_points(crf1d_context_t *ctx, floatval_t *probs)
+{
+    int l, t;
+    const int T = ctx->num_items;
+    const int L = ctx->num_labels;
+
+    /*
+        Store the marginal probabilities of all the labels at all the
+        positions, p(t,l) at probs[t * L + l], as crf1dc_marginal_point().
+     */
+    for (t = 0;t < T;++t) {
+        const floatval_t *fwd = ALPHA_SCORE(ctx, t);
+        const floatval_t *bwd = BETA_SCORE(ctx, t);
+        floatval_t *prob = &probs[t * L];
+        for (l = 0;l < L;++l) {
+            prob[l] = fwd[l] * bwd[l] / ctx->scale_factor[t];
+        }
+    }
+}
+
 floatval_t crf1dc_marginal_path(crf1d_context_t *ctx, const int *path, int begin, int end)
 {
     int t;
@@ -536,6 +543,99 @@ floatval_t crf1dc_viterbi(crf1d_context_t* ctx, int *labels)
     return max_score;
 }
 
+floatval_t crf1dc_viterbi_lognorm(crf1d_context_t* ctx, int *labels)
+{
+    int i, j, t;
+    int *back = NULL;
+    floatval_t max_score, score, sum, *cur = NULL, *alpha = NULL, *exp_state = NULL;
+    floatval_t *scale = &ctx->scale_factor[0];
+    int argmax_score;
+    const floatval_t *prev = NULL, *state = NULL, *trans = NULL;
+    const int T = ctx->num_items;
+    const int L = ctx->num_labels;
+
+    /*
+        This function computes the Viterbi path and the alpha scores in a
+        single pass over the items, with the same results as crf1dc_viterbi(),
+        crf1dc_exp_state() and crf1dc_alpha_score() in a row. The Viterbi
+        scores are stored in the beta scores, which are left invalid.
+        The state scores are exponentiated in one go, as vecexp_n() gives
+        the same results for a row only when it spans whole SIMD blocks.
+     */
+    crf1dc_exp_state(ctx);
+
+    /* Compute the scores at (0, *). */
+    cur = BETA_SCORE(ctx, 0);
+    state = STATE_SCORE(ctx, 0);
+    veccopy(cur, state, L);
+
+    exp_state = EXP_STATE_SCORE(ctx, 0);
+    alpha = ALPHA_SCORE(ctx, 0);
+    veccopy(alpha, exp_state, L);
+    sum = vecsum(alpha, L);
+    *scale = (sum != 0.) ? 1. / sum : 1.;
+    vecscale(alpha, *scale, L);
+    ++scale;
+
+    /* Compute the scores at (t, *). */
+    for (t = 1;t < T;++t) {
+        prev = BETA_SCORE(ctx, t-1);
+        cur = BETA_SCORE(ctx, t);
+        state = STATE_SCORE(ctx, t);
+        back = BACKWARD_EDGE_AT(ctx, t);
+
+        /* Compute the Viterbi score of (t, j). */
+        for (j = 0;j < L;++j) {
+            max_score = -FLOAT_MAX;
+            argmax_score = -1;
+            for (i = 0;i < L;++i) {
+                trans = TRANS_SCORE(ctx, i);
+                score = prev[i] + trans[j];
+                if (max_score < score) {
+                    max_score = score;
+                    argmax_score = i;
+                }
+            }
+            if (argmax_score >= 0) back[j] = argmax_score;
+            cur[j] = max_score + state[j];
+        }
+
+        /* Compute the alpha score of (t, *). */
+        exp_state = EXP_STATE_SCORE(ctx, t);
+
+        prev = ALPHA_SCORE(ctx, t-1);
+        alpha = ALPHA_SCORE(ctx, t);
+        vecmatvec_t(alpha, prev, EXP_TRANS_SCORE(ctx, 0), L);
+        vecmul(alpha, exp_state, L);
+        sum = vecsum(alpha, L);
+        *scale = (sum != 0.) ? 1. / sum : 1.;
+        vecscale(alpha, *scale, L);
+        ++scale;
+    }
+
+    ctx->log_norm = -vecsumlog(ctx->scale_factor, T);
+
+    /* Find the node (#T, #i) that reaches EOS with the maximum score. */
+    max_score = -FLOAT_MAX;
+    prev = BETA_SCORE(ctx, T-1);
+    labels[T-1] = 0;
+    for (i = 0;i < L;++i) {
+        if (max_score < prev[i]) {
+            max_score = prev[i];
+            labels[T-1] = i;
+        }
+    }
+
+    /* Tag labels by tracing the backward links. */
+    for (t = T-2;0 <= t;--t) {
+        back = BACKWARD_EDGE_AT(ctx, t+1);
+        labels[t] = back[labels[t+1]];
+    }
+
+    /* Return the maximum score (without the normalization factor subtracted). */
+    return max_score;
+}
+
 static void check_values(FILE *fp, floatval_t cv, floatval_t tv)
 {
     if (fabs(cv - tv) < 1e-9) {
@@ -41,6 +41,13 @@
 #include <memory.h>
 #include <time.h>
 
+#ifdef    _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif/*_WIN32*/
+
 #include <crfsuite.h>
 #include "crfsuite_internal.h"
 #include "crf1d.h"
@@ -54,6 +61,7 @@ typedef struct {
     floatval_t  feature_minfreq;                /** The threshold for occurrences of features. */
     int         feature_possible_states;        /** Dense state features. */
     int         feature_possible_transitions;   /** Dense transition features. */
+    int         num_threads;                    /** Threads computing the gradients of a data set. */
 } crf1de_option_t;
 
 /**
@@ -72,8 +80,29 @@ typedef struct {
 
     crf1d_context_t *ctx;           /**< CRF1d context. */
     crf1de_option_t opt;            /**< CRF1d options. */
+
+    int num_shards;                 /**< Number of extra threads computing the gradients. */
+    crf1d_context_t **shard_ctxs;   /**< CRF1d context of every extra thread [num_shards]. */
+    floatval_t *shard_gradients;    /**< Gradients of every extra thread [num_shards * K]. */
 } crf1de_t;
 
+/**
+ * A contiguous range of the instances of a data set, whose objective and
+ * gradients are computed by one thread.
+ */
+typedef struct {
+    crf1de_t crf1de;                /**< Copy of the encoder, with the context of this thread. */
+    dataset_t *ds;
+    const floatval_t *w;
+    floatval_t *g;                  /**< Gradients receiving the model expectations. */
+    int begin;
+    int end;
+    floatval_t logl;                /**< Log-likelihood of the range. */
+} crf1de_shard_t;
+
+/** Ceiling of num_threads when the number of processors is unknown. */
+#define    CRF1DE_MAX_THREADS  64
+
 #define    FEATURE(crf1de, k) \
     (&(crf1de)->features[(k)])
 #define    ATTRIBUTE(crf1de, a) \
@@ -93,13 +122,35 @@ static void crf1de_init(crf1de_t *crf1de)
     crf1de->attributes = NULL;
     crf1de->forward_trans = NULL;
     crf1de->ctx = NULL;
+    crf1de->num_shards = 0;
+    crf1de->shard_ctxs = NULL;
+    crf1de->shard_gradients = NULL;
     /* Initialize except for opt. */
 }
 
+static void crf1de_free_shards(crf1de_t *crf1de)
+{
+    int i;
+
+    if (crf1de->shard_ctxs != NULL) {
+        for (i = 0;i < crf1de->num_shards;++i) {
+            if (crf1de->shard_ctxs[i] != NULL) {
+                crf1dc_delete(crf1de->shard_ctxs[i]);
+            }
+        }
+        free(crf1de->shard_ctxs);
+        crf1de->shard_ctxs = NULL;
+    }
+    free(crf1de->shard_gradients);
+    crf1de->shard_gradients = NULL;
+    crf1de->num_shards = 0;
+}
+
 static void crf1de_finish(crf1de_t *crf1de)
 {
     int i;
 
+    crf1de_free_shards(crf1de);
     if (crf1de->ctx != NULL) {
         crf1dc_delete(crf1de->ctx);
         crf1de->ctx = NULL;
@@ -706,6 +757,12 @@ static int crf1de_exchange_options(crfsuite_params_t* params, crf1de_option_t* o
             "feature.possible_transitions", opt->feature_possible_transitions, 0,
             "Force to generate possible transition features."
             )
+        DDX_PARAM_INT(
+            "num_threads", opt->num_threads, 1,
+            "The number of threads computing the objective and gradients of the data set\n"
+            "(L-BFGS), at most the number of processors. The results only depend on the\n"
+            "data and the number of threads."
+            )
     END_PARAM_MAP()
 
     return 0;
@@ -794,41 +851,34 @@ static int encoder_initialize(encoder_t *self, dataset_t *ds, logging_t *lg)
     return ret;
 }
 
-/* LEVEL_NONE -> LEVEL_NONE. */
-static int encoder_objective_and_gradients_batch(encoder_t *self, dataset_t *ds, const floatval_t *w, floatval_t *f, floatval_t *g)
+/*
+    Computes the log-likelihood of the instances [begin, end) of a data set,
+    and adds the model expectations of the features to the gradients.
+ */
+static void crf1de_shard_run(crf1de_shard_t *shard)
 {
     int i;
     floatval_t logp = 0, logl = 0;
-    crf1de_t *crf1de = (crf1de_t*)self->internal;
-    const int N = ds->num_instances;
-    const int K = crf1de->num_features;
-
-    /*
-        Initialize the gradients with observation expectations.
-     */
-    for (i = 0;i < K;++i) {
-        crf1df_feature_t* f = &crf1de->features[i];
-        g[i] = -f->freq;
-    }
+    crf1de_t *crf1de = &shard->crf1de;
 
     /*
         Set the scores (weights) of transition features here because
         these are independent of input label sequences.
      */
     crf1dc_reset(crf1de->ctx, RF_TRANS);
-    crf1de_transition_score(crf1de, w);
+    crf1de_transition_score(crf1de, shard->w);
     crf1dc_exp_transition(crf1de->ctx);
 
     /*
         Compute model expectations.
      */
-    for (i = 0;i < N;++i) {
-        const crfsuite_instance_t *seq = dataset_get(ds, i);
+    for (i = shard->begin;i < shard->end;++i) {
+        const crfsuite_instance_t *seq = dataset_get(shard->ds, i);
 
         /* Set label sequences and state scores. */
         crf1dc_set_num_items(crf1de->ctx, seq->num_items);
         crf1dc_reset(crf1de->ctx, RF_STATE);
-        crf1de_state_score(crf1de, seq, w);
+        crf1de_state_score(crf1de, seq, shard->w);
         crf1dc_exp_state(crf1de->ctx);
 
         /* Compute forward/backward scores. */
@@ -842,9 +892,181 @@ static int encoder_objective_and_gradients_batch(encoder_t *self, dataset_t *ds,
         logl += logp * seq->weight;
 
         /* Update the model expectations of features. */
-        crf1de_model_expectation(crf1de, seq, g, seq->weight);
+        crf1de_model_expectation(crf1de, seq, shard->g, seq->weight);
+    }
+
+    shard->logl = logl;
+}
+
+#ifdef    _WIN32
+typedef HANDLE crf1de_thread_t;
+
+static DWORD WINAPI crf1de_thread_main(LPVOID arg)
+{
+    crf1de_shard_run((crf1de_shard_t*)arg);
+    return 0;
+}
+
+static int crf1de_thread_start(crf1de_thread_t *thread, crf1de_shard_t *shard)
+{
+    *thread = CreateThread(NULL, 0, crf1de_thread_main, shard, 0, NULL);
+    return *thread == NULL;
+}
+
+static void crf1de_thread_join(crf1de_thread_t thread)
+{
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+
+static int crf1de_num_processors(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+}
+#else
+typedef pthread_t crf1de_thread_t;
+
+static void *crf1de_thread_main(void *arg)
+{
+    crf1de_shard_run((crf1de_shard_t*)arg);
+    return NULL;
+}
+
+static int crf1de_thread_start(crf1de_thread_t *thread, crf1de_shard_t *shard)
+{
+    return pthread_create(thread, NULL, crf1de_thread_main, shard);
+}
+
+static void crf1de_thread_join(crf1de_thread_t thread)
+{
+    pthread_join(thread, NULL);
+}
+
+static int crf1de_num_processors(void)
+{
+    return (int)sysconf(_SC_NPROCESSORS_ONLN);
+}
+#endif/*_WIN32*/
+
+/*
+    Allocates the contexts and gradients of the extra threads, once for the
+    whole training.
+ */
+static int crf1de_init_shards(crf1de_t *crf1de, int num_shards)
+{
+    int i;
+    const int K = crf1de->num_features;
+
+    crf1de_free_shards(crf1de);
+    crf1de->shard_ctxs = (crf1d_context_t**)calloc(num_shards, sizeof(crf1d_context_t*));
+    crf1de->shard_gradients = (floatval_t*)calloc((size_t)num_shards * K + 1, sizeof(floatval_t));
+    if (crf1de->shard_ctxs == NULL || crf1de->shard_gradients == NULL) {
+        crf1de_free_shards(crf1de);
+        return CRFSUITEERR_OUTOFMEMORY;
+    }
+    crf1de->num_shards = num_shards;
+    for (i = 0;i < num_shards;++i) {
+        crf1de->shard_ctxs[i] = crf1dc_new(CTXF_MARGINALS | CTXF_VITERBI, crf1de->num_labels, crf1de->cap_items);
+        if (crf1de->shard_ctxs[i] == NULL) {
+            crf1de_free_shards(crf1de);
+            return CRFSUITEERR_OUTOFMEMORY;
+        }
+    }
+    return 0;
+}
+
+/* LEVEL_NONE -> LEVEL_NONE. */
+static int encoder_objective_and_gradients_batch(encoder_t *self, dataset_t *ds, const floatval_t *w, floatval_t *f, floatval_t *g)
+{
+    int i, k, n, ret;
+    floatval_t logl = 0;
+    crf1de_t *crf1de = (crf1de_t*)self->internal;
+    crf1de_shard_t *shards = NULL;
+    crf1de_thread_t *threads = NULL;
+    int *started = NULL;
+    const int N = ds->num_instances;
+    const int K = crf1de->num_features;
+
+    /*
+        Initialize the gradients with observation expectations.
+     */
+    for (i = 0;i < K;++i) {
+        crf1df_feature_t* f = &crf1de->features[i];
+        g[i] = -f->freq;
     }
 
+    /*
+        Split the instances in contiguous ranges, one per thread. The first
+        range is computed by this thread, with the context of the encoder.
+     */
+    n = crf1de->opt.num_threads;
+    if (N < n) n = N;
+    k = crf1de_num_processors();
+    if (k < 1) k = CRF1DE_MAX_THREADS;
+    if (k < n) n = k;
+    if (n < 1) n = 1;
+    if (1 < n && crf1de->num_shards != n-1) {
+        if ((ret = crf1de_init_shards(crf1de, n-1))) {
+            return ret;
+        }
+    }
+
+    shards = (crf1de_shard_t*)calloc(n, sizeof(crf1de_shard_t));
+    threads = (crf1de_thread_t*)calloc(n, sizeof(crf1de_thread_t));
+    started = (int*)calloc(n, sizeof(int));
+    if (shards == NULL || threads == NULL || started == NULL) {
+        free(shards);
+        free(threads);
+        free(started);
+        return CRFSUITEERR_OUTOFMEMORY;
+    }
+
+    for (k = 0;k < n;++k) {
+        crf1de_shard_t *shard = &shards[k];
+        shard->crf1de = *crf1de;
+        shard->ds = ds;
+        shard->w = w;
+        shard->begin = (int)((long long)N * k / n);
+        shard->end = (int)((long long)N * (k+1) / n);
+        if (0 < k) {
+            shard->crf1de.ctx = crf1de->shard_ctxs[k-1];
+            shard->g = &crf1de->shard_gradients[(size_t)(k-1) * K];
+            memset(shard->g, 0, sizeof(floatval_t) * K);
+            /* Run the range on this thread if no thread can be started. */
+            started[k] = !crf1de_thread_start(&threads[k], shard);
+        } else {
+            shard->g = g;
+        }
+    }
+
+    crf1de_shard_run(&shards[0]);
+    for (k = 1;k < n;++k) {
+        if (started[k]) {
+            crf1de_thread_join(threads[k]);
+        } else {
+            crf1de_shard_run(&shards[k]);
+        }
+    }
+
+    /*
+        Reduce the ranges in a fixed order, so that the results only depend
+        on the number of threads.
+     */
+    logl = shards[0].logl;
+    for (k = 1;k < n;++k) {
+        const floatval_t *gk = shards[k].g;
+        for (i = 0;i < K;++i) {
+            g[i] += gk[i];
+        }
+        logl += shards[k].logl;
+    }
+
+    free(shards);
+    free(threads);
+    free(started);
+
     *f = -logl;
     return 0;
 }
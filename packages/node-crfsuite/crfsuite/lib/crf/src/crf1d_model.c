@@ -95,6 +95,15 @@ struct tag_crf1dm {
     header_t*      header;
     cqdb_t*        labels;
     cqdb_t*        attrs;
+
+    /* The features decoded at open, so that tagging does not parse the model
+       buffer: the state features of attribute #a are the (label, weight)
+       pairs in [state_offsets[a], state_offsets[a+1]), and the weight of the
+       transition (i -> j) is trans[i * L + j]. */
+    int*           state_offsets;
+    int*           state_labels;
+    floatval_t*    state_weights;
+    floatval_t*    trans;
 };
 
 struct tag_crf1dmw {
@@ -700,6 +709,85 @@ int crf1dmw_put_feature(crf1dmw_t* writer, int fid, const crf1dm_feature_t* f)
     return 0;
 }
 
+static void crf1dm_free_features(crf1dm_t* model)
+{
+    free(model->state_offsets);
+    free(model->state_labels);
+    free(model->state_weights);
+    free(model->trans);
+    model->state_offsets = NULL;
+    model->state_labels = NULL;
+    model->state_weights = NULL;
+    model->trans = NULL;
+}
+
+static int crf1dm_decode_features(crf1dm_t* model)
+{
+    int a, i, r, fid, n = 0;
+    uint32_t K = 0;
+    feature_refs_t refs;
+    crf1dm_feature_t f;
+    const int A = (int)model->header->num_attrs;
+    const int L = (int)model->header->num_labels;
+
+    /* The number of features is only stored in the header of the FEAT chunk. */
+    read_uint32(model->buffer + model->header->off_features + 8, &K);
+
+    /* Count the state features of every attribute. */
+    model->state_offsets = (int*)calloc(A + 1, sizeof(int));
+    if (model->state_offsets == NULL) {
+        return CRFSUITEERR_OUTOFMEMORY;
+    }
+    for (a = 0;a < A;++a) {
+        crf1dm_get_attrref(model, a, &refs);
+        model->state_offsets[a] = n;
+        n += refs.num_features;
+    }
+    model->state_offsets[A] = n;
+
+    model->state_labels = (int*)calloc(n + 1, sizeof(int));
+    model->state_weights = (floatval_t*)calloc(n + 1, sizeof(floatval_t));
+    model->trans = (floatval_t*)calloc((size_t)L * L + 1, sizeof(floatval_t));
+    if (model->state_labels == NULL || model->state_weights == NULL || model->trans == NULL) {
+        return CRFSUITEERR_OUTOFMEMORY;
+    }
+
+    /* Decode the state features, in the order of the attribute references. */
+    for (a = 0;a < A;++a) {
+        crf1dm_get_attrref(model, a, &refs);
+        for (r = 0;r < refs.num_features;++r) {
+            fid = crf1dm_get_featureid(&refs, r);
+            if (fid < 0 || K <= (uint32_t)fid) {
+                return CRFSUITEERR_INCOMPATIBLE;
+            }
+            crf1dm_get_feature(model, fid, &f);
+            if (f.dst < 0 || L <= f.dst) {
+                return CRFSUITEERR_INCOMPATIBLE;
+            }
+            model->state_labels[model->state_offsets[a] + r] = f.dst;
+            model->state_weights[model->state_offsets[a] + r] = f.weight;
+        }
+    }
+
+    /* Decode the transition features into a dense matrix. */
+    for (i = 0;i < L;++i) {
+        crf1dm_get_labelref(model, i, &refs);
+        for (r = 0;r < refs.num_features;++r) {
+            fid = crf1dm_get_featureid(&refs, r);
+            if (fid < 0 || K <= (uint32_t)fid) {
+                return CRFSUITEERR_INCOMPATIBLE;
+            }
+            crf1dm_get_feature(model, fid, &f);
+            if (f.dst < 0 || L <= f.dst) {
+                return CRFSUITEERR_INCOMPATIBLE;
+            }
+            model->trans[i * L + f.dst] = f.weight;
+        }
+    }
+
+    return 0;
+}
+
 static crf1dm_t* crf1dm_new_impl(uint8_t* buffer_orig, const uint8_t* buffer, uint32_t size)
 {
     const uint8_t* p = NULL;
@@ -750,11 +838,18 @@ static crf1dm_t* crf1dm_new_impl(uint8_t* buffer_orig, const uint8_t* buffer, ui
         model->size - header->off_attrs
         );
 
+    if (crf1dm_decode_features(model) != 0) {
+        model->buffer_orig = NULL;
+        crf1dm_close(model);
+        goto error_exit_buffer;
+    }
+
     return model;
 
 error_exit:
     free(header);
     free(model);
+error_exit_buffer:
     free(buffer_orig);
     return NULL;
 }
@@ -807,6 +902,7 @@ crf1dm_t* crf1dm_new_from_memory(const void *data, size_t size)
 
 void crf1dm_close(crf1dm_t* model)
 {
+    crf1dm_free_features(model);
     if (model->labels != NULL) {
         cqdb_delete(model->labels);
     }
@@ -933,6 +1029,19 @@ int crf1dm_get_feature(crf1dm_t* model, int fid, crf1dm_feature_t* f)
     return 0;
 }
 
+int crf1dm_get_state_features(crf1dm_t* model, int aid, const int** labels, const floatval_t** weights)
+{
+    const int begin = model->state_offsets[aid];
+    *labels = &model->state_labels[begin];
+    *weights = &model->state_weights[begin];
+    return model->state_offsets[aid+1] - begin;
+}
+
+const floatval_t* crf1dm_get_transitions(crf1dm_t* model)
+{
+    return model->trans;
+}
+
 void crf1dm_dump(crf1dm_t* crf1dm, FILE *fp)
 {
     int j;
@@ -61,15 +61,14 @@ typedef struct {
 
 static void crf1dt_state_score(crf1dt_t *crf1dt, const crfsuite_instance_t *inst)
 {
-    int a, i, l, t, r, fid;
-    crf1dm_feature_t f;
-    feature_refs_t attr;
+    int i, r, n, t;
+    const int *labels = NULL;
+    const floatval_t *weights = NULL;
     floatval_t value, *state = NULL;
     crf1dm_t* model = crf1dt->model;
     crf1d_context_t* ctx = crf1dt->ctx;
     const crfsuite_item_t* item = NULL;
     const int T = inst->num_items;
-    const int L = crf1dt->num_labels;
 
     /* Loop over the items in the sequence. */
     for (t = 0;t < T;++t) {
@@ -78,20 +77,14 @@ static void crf1dt_state_score(crf1dt_t *crf1dt, const crfsuite_instance_t *inst
 
         /* Loop over the contents (attributes) attached to the item. */
         for (i = 0;i < item->num_contents;++i) {
-            /* Access the list of state features associated with the attribute. */
-            a = item->contents[i].aid;
-            crf1dm_get_attrref(model, a, &attr);
+            /* Access the state features associated with the attribute, as
+               the labels they output and their weights. */
+            n = crf1dm_get_state_features(model, item->contents[i].aid, &labels, &weights);
             /* A scale usually represents the atrribute frequency in the item. */
             value = item->contents[i].value;
 
-            /* Loop over the state features associated with the attribute. */
-            for (r = 0;r < attr.num_features;++r) {
-                /* The state feature #(attr->fids[r]), which is represented by
-                   the attribute #a, outputs the label #(f->dst). */
-                fid = crf1dm_get_featureid(&attr, r);
-                crf1dm_get_feature(model, fid, &f);
-                l = f.dst;
-                state[l] += f.weight * value;
+            for (r = 0;r < n;++r) {
+                state[labels[r]] += weights[r] * value;
             }
         }
     }
@@ -99,25 +92,11 @@ static void crf1dt_state_score(crf1dt_t *crf1dt, const crfsuite_instance_t *inst
 
 static void crf1dt_transition_score(crf1dt_t* crf1dt)
 {
-    int i, r, fid;
-    crf1dm_feature_t f;
-    feature_refs_t edge;
-    floatval_t *trans = NULL;
-    crf1dm_t* model = crf1dt->model;
     crf1d_context_t* ctx = crf1dt->ctx;
     const int L = crf1dt->num_labels;
 
-    /* Compute transition scores between two labels. */
-    for (i = 0;i < L;++i) {
-        trans = TRANS_SCORE(ctx, i);
-        crf1dm_get_labelref(model, i, &edge);
-        for (r = 0;r < edge.num_features;++r) {
-            /* Transition feature from #i to #(f->dst). */
-            fid = crf1dm_get_featureid(&edge, r);
-            crf1dm_get_feature(model, fid, &f);
-            trans[f.dst] = f.weight;
-        }        
-    }
+    /* Copy the transition scores between two labels, decoded with the model. */
+    memcpy(ctx->trans, crf1dm_get_transitions(crf1dt->model), sizeof(floatval_t) * L * L);
 }
 
 static void crf1dt_set_level(crf1dt_t *crf1dt, int level)
@@ -244,6 +223,24 @@ static int tagger_lognorm(crfsuite_tagger_t* tagger, floatval_t *ptr_norm)
     return 0;
 }
 
+static int tagger_viterbi_lognorm(crfsuite_tagger_t* tagger, int *labels, floatval_t *ptr_score, floatval_t *ptr_norm)
+{
+    floatval_t score;
+    crf1dt_t* crf1dt = (crf1dt_t*)tagger->internal;
+    crf1d_context_t* ctx = crf1dt->ctx;
+
+    score = crf1dc_viterbi_lognorm(ctx, labels);
+    /* The beta scores were overwritten. */
+    crf1dt->level = LEVEL_SET;
+    if (ptr_score != NULL) {
+        *ptr_score = score;
+    }
+    if (ptr_norm != NULL) {
+        *ptr_norm = crf1dc_lognorm(ctx);
+    }
+    return 0;
+}
+
 static int tagger_marginal_point(crfsuite_tagger_t *tagger, int l, int t, floatval_t *ptr_prob)
 {
     crf1dt_t* crf1dt = (crf1dt_t*)tagger->internal;
@@ -252,6 +249,14 @@ static int tagger_marginal_point(crfsuite_tagger_t *tagger, int l, int t, floatv
     return 0;
 }
 
+static int tagger_marginals(crfsuite_tagger_t *tagger, floatval_t *probs)
+{
+    crf1dt_t* crf1dt = (crf1dt_t*)tagger->internal;
+    crf1dt_set_level(crf1dt, LEVEL_ALPHABETA);
+    crf1dc_marginal_points(crf1dt->ctx, probs);
+    return 0;
+}
+
 static int tagger_marginal_path(crfsuite_tagger_t *tagger, const int *path, int begin, int end, floatval_t *ptr_prob)
 {
     crf1dt_t* crf1dt = (crf1dt_t*)tagger->internal;
@@ -424,6 +429,8 @@ static int model_get_tagger(crfsuite_model_t* model, crfsuite_tagger_t** ptr_tag
     tagger->lognorm = tagger_lognorm;
     tagger->marginal_point = tagger_marginal_point;
     tagger->marginal_path = tagger_marginal_path;
+    tagger->viterbi_lognorm = tagger_viterbi_lognorm;
+    tagger->marginals = tagger_marginals;
 
     *ptr_tagger = tagger;
     return 0;
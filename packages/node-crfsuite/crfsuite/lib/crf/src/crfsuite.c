@@ -299,6 +299,35 @@ int  crfsuite_data_append(crfsuite_data_t* data, const crfsuite_instance_t* inst
     return 0;
 }
 
+int  crfsuite_data_reserve(crfsuite_data_t* data, int n)
+{
+    if (data->cap_instances < data->num_instances + n) {
+        const int cap = data->num_instances + n;
+        crfsuite_instance_t* instances = (crfsuite_instance_t*)realloc(
+            data->instances, sizeof(crfsuite_instance_t) * cap);
+        if (instances == NULL) {
+            return -1;
+        }
+        data->instances = instances;
+        data->cap_instances = cap;
+    }
+    return 0;
+}
+
+int  crfsuite_data_append_move(crfsuite_data_t* data, crfsuite_instance_t* inst)
+{
+    if (0 < inst->num_items) {
+        if (data->cap_instances <= data->num_instances) {
+            if (crfsuite_data_reserve(data, data->cap_instances + 2) != 0) {
+                return -1;
+            }
+        }
+        data->instances[data->num_instances++] = *inst;
+        crfsuite_instance_init(inst);
+    }
+    return 0;
+}
+
 int crfsuite_data_maxlength(crfsuite_data_t* data)
 {
     int i, T = 0;
@@ -33,62 +33,121 @@
 #include "os.h"
 #include <stdlib.h>
 #include <string.h>
-#include "rumavl.h"
 #include "quark.h"
 
-typedef struct {
-    char *str;
-    int qid;
-} record_t;
+/*
+    Strings are interned in an open-addressing hash table (linear probing)
+    that stores their ids. The strings themselves are copied in blocks of
+    QUARK_BLOCK_SIZE bytes, freed all at once with the quark.
+ */
+#define QUARK_BLOCK_SIZE    65536
+#define QUARK_MIN_TABLE     64
+
+typedef struct tag_block {
+    struct tag_block *next;
+} block_t;
 
 struct tag_quark {
     int num;
     int max;
-    RUMAVL* string_to_id;
     char **id_to_string;
+    unsigned int *id_to_hash;
+
+    /* Ids of the strings by hash, -1 for empty slots; size is a power of 2. */
+    int *table;
+    int table_size;
+
+    block_t *blocks;
+    char *free_ptr;
+    size_t free_size;
 };
 
-static int keycmp(const void *_x, const void *_y, size_t n, void *udata)
+static unsigned int hash_string(const char *str, size_t *length)
 {
-    const record_t* x = (const record_t*)_x;
-    const record_t* y = (const record_t*)_y;
-    return strcmp(x->str, y->str);
+    /* 32-bit FNV-1a. */
+    const unsigned char *p = (const unsigned char*)str;
+    unsigned int h = 2166136261u;
+    for (;*p;++p) {
+        h ^= *p;
+        h *= 16777619u;
+    }
+    *length = (size_t)(p - (const unsigned char*)str);
+    return h;
 }
 
-static int owcb(RUMAVL *tree, RUMAVL_NODE *n, void *_x, const void *_y, void *udata)
+static int *find_slot(quark_t* qrk, const char *str, unsigned int h)
 {
-    record_t* x = (record_t*)_x;
-    free(x->str);
-    return 0;
+    const unsigned int mask = (unsigned int)qrk->table_size - 1;
+    unsigned int i = h & mask;
+
+    for (;;) {
+        int qid = qrk->table[i];
+        if (qid < 0 || (qrk->id_to_hash[qid] == h && strcmp(qrk->id_to_string[qid], str) == 0)) {
+            return &qrk->table[i];
+        }
+        i = (i + 1) & mask;
+    }
 }
 
-static int delcb(RUMAVL *tree, RUMAVL_NODE *n, void *_record, void *udata)
+static int resize_table(quark_t* qrk, int size)
 {
-    record_t* record = (record_t*)_record;
-    free(record->str);
+    int i;
+    int *table = (int*)malloc(sizeof(int) * size);
+    if (table == NULL) {
+        return -1;
+    }
+    for (i = 0;i < size;++i) {
+        table[i] = -1;
+    }
+
+    free(qrk->table);
+    qrk->table = table;
+    qrk->table_size = size;
+    for (i = 0;i < qrk->num;++i) {
+        *find_slot(qrk, qrk->id_to_string[i], qrk->id_to_hash[i]) = i;
+    }
     return 0;
 }
 
-quark_t* quark_new()
+static char *copy_string(quark_t* qrk, const char *str, size_t length)
 {
-    quark_t* qrk = (quark_t*)malloc(sizeof(quark_t));
-    if (qrk != NULL) {
-        qrk->num = 0;
-        qrk->max = 0;
-        qrk->string_to_id = rumavl_new(sizeof(record_t), keycmp, NULL, NULL);
-        if (qrk->string_to_id != NULL) {
-            *rumavl_delcb(qrk->string_to_id) = delcb;
-            *rumavl_owcb(qrk->string_to_id) = owcb;
+    char *dst = NULL;
+
+    if (qrk->free_size < length + 1) {
+        size_t size = (length + 1 < QUARK_BLOCK_SIZE) ? QUARK_BLOCK_SIZE : length + 1;
+        block_t *block = (block_t*)malloc(sizeof(block_t) + size);
+        if (block == NULL) {
+            return NULL;
         }
-        qrk->id_to_string = NULL;
+        block->next = qrk->blocks;
+        qrk->blocks = block;
+        qrk->free_ptr = (char*)(block + 1);
+        qrk->free_size = size;
     }
-    return qrk;
+
+    dst = qrk->free_ptr;
+    memcpy(dst, str, length + 1);
+    qrk->free_ptr += length + 1;
+    qrk->free_size -= length + 1;
+    return dst;
+}
+
+quark_t* quark_new()
+{
+    return (quark_t*)calloc(1, sizeof(quark_t));
 }
 
 void quark_delete(quark_t* qrk)
 {
     if (qrk != NULL) {
-        rumavl_destroy(qrk->string_to_id);
+        block_t *block = qrk->blocks;
+        while (block != NULL) {
+            block_t *next = block->next;
+            free(block);
+            block = next;
+        }
+        free(qrk->table);
+        free(qrk->id_to_hash);
         free(qrk->id_to_string);
         free(qrk);
     }
@@ -96,45 +155,69 @@ void quark_delete(quark_t* qrk)
 
 int quark_get(quark_t* qrk, const char *str)
 {
-    record_t key, *record = NULL;
-
-    key.str = (char *)str;
-    record = (record_t*)rumavl_find(qrk->string_to_id, &key);
-    if (record == NULL) {
-        char *newstr = (char*)malloc(strlen(str)+1);
-        if (newstr != NULL) {
-            strcpy(newstr, str);
+    size_t length;
+    int *slot = NULL;
+    char *newstr = NULL;
+    const unsigned int h = hash_string(str, &length);
+
+    if (0 < qrk->table_size) {
+        slot = find_slot(qrk, str, h);
+        if (0 <= *slot) {
+            return *slot;
         }
+    }
 
-        if (qrk->max <= qrk->num) {
-            qrk->max = (qrk->max + 1) * 2;
-            qrk->id_to_string = (char **)realloc(qrk->id_to_string, sizeof(char *) * qrk->max);
+    /* Keep the table at most half full. */
+    if (qrk->table_size < (qrk->num + 1) * 2) {
+        int size = (qrk->table_size < QUARK_MIN_TABLE) ? QUARK_MIN_TABLE : qrk->table_size * 2;
+        if (resize_table(qrk, size) != 0) {
+            return -1;
         }
+        slot = find_slot(qrk, str, h);
+    }
 
-        qrk->id_to_string[qrk->num] = newstr;
-        key.str = newstr;
-        key.qid = qrk->num;
-        rumavl_insert(qrk->string_to_id, &key);
+    if (qrk->max <= qrk->num) {
+        int max = (qrk->max + 1) * 2;
+        char **strings = (char **)realloc(qrk->id_to_string, sizeof(char *) * max);
+        unsigned int *hashes = NULL;
+        if (strings == NULL) {
+            return -1;
+        }
+        qrk->id_to_string = strings;
+        hashes = (unsigned int *)realloc(qrk->id_to_hash, sizeof(unsigned int) * max);
+        if (hashes == NULL) {
+            return -1;
+        }
+        qrk->id_to_hash = hashes;
+        qrk->max = max;
+    }
 
-        ++qrk->num;
-        return key.qid;
-    } else {
-        return record->qid;
-    }    
+    newstr = copy_string(qrk, str, length);
+    if (newstr == NULL) {
+        return -1;
+    }
+
+    qrk->id_to_string[qrk->num] = newstr;
+    qrk->id_to_hash[qrk->num] = h;
+    *slot = qrk->num;
+    return qrk->num++;
 }
 
 int quark_to_id(quark_t* qrk, const char *str)
 {
-    record_t key, *record = NULL;
+    size_t length;
+    unsigned int h;
 
-    key.str = (char *)str;
-    record = (record_t*)rumavl_find(qrk->string_to_id, &key);
-    return (record != NULL) ? record->qid : -1;
+    if (qrk->table_size == 0) {
+        return -1;
+    }
+    h = hash_string(str, &length);
+    return *find_slot(qrk, str, h);
 }
 
 const char *quark_to_string(quark_t* qrk, int qid)
 {
-    return (qid < qrk->num) ? qrk->id_to_string[qid] : NULL;
+    return (0 <= qid && qid < qrk->num) ? qrk->id_to_string[qid] : NULL;
 }
 
 int quark_num(quark_t* qrk)
@@ -0,0 +1,292 @@
+/*
+ *      Vector kernels of the forward-backward algorithm.
+ *
+ * Each kernel has a portable implementation and, on x86 CPUs supporting
+ * them, an AVX2/FMA implementation selected at run time. The library is
+ * built for the baseline instruction set; the AVX2 functions are compiled
+ * for their own target, and only called after the CPU was checked.
+ */
+
+/* $Id$ */
+
+#ifdef    HAVE_CONFIG_H
+#include <config.h>
+#endif/*HAVE_CONFIG_H*/
+
+#include <os.h>
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <crfsuite.h>
+
+#include "vecmath.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VECMATH_AVX2    1
+#define AVX2_TARGET     __attribute__((target("avx2,fma")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define VECMATH_AVX2    1
+#define AVX2_TARGET
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+#ifdef  VECMATH_AVX2
+
+static int cpu_has_avx2(void)
+{
+#if defined(__GNUC__)
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+    /* -1 until the CPU was checked; concurrent checks store the same value. */
+    static volatile int has_avx2 = -1;
+    if (has_avx2 < 0) {
+        int info[4], ret = 0;
+        __cpuid(info, 0);
+        if (7 <= info[0]) {
+            __cpuid(info, 1);
+            /* FMA, OSXSAVE and AVX, with the YMM state enabled by the OS. */
+            if ((info[2] & 0x18001000) == 0x18001000 && (_xgetbv(0) & 6) == 6) {
+                __cpuidex(info, 7, 0);
+                ret = (info[1] & 0x20) != 0;
+            }
+        }
+        has_avx2 = ret;
+    }
+    return has_avx2;
+#endif
+}
+
+/* Lanes [0, r) of a vector, for the last 1 to 3 elements of a row. */
+AVX2_TARGET static __m256i avx2_mask(const int r)
+{
+    return _mm256_cmpgt_epi64(_mm256_set1_epi64x(r), _mm256_setr_epi64x(0, 1, 2, 3));
+}
+
+AVX2_TARGET static void vecexp_avx2(double *values, const int n)
+{
+    /* The approximation of the SSE2 vecexp() in vecmath.h, four at a time. */
+    int i;
+    const __m256d log2e = _mm256_set1_pd(1.4426950408889634073599);
+    const __m256d maxlog = _mm256_set1_pd(7.09782712893383996843e2);   // log(2**1024)
+    const __m256d minlog = _mm256_set1_pd(-7.08396418532264106224e2);  // log(2**-1022)
+    const __m256d c1 = _mm256_set1_pd(6.93145751953125E-1);
+    const __m256d c2 = _mm256_set1_pd(1.42860682030941723212E-6);
+    const __m256i offset = _mm256_set1_epi64x(1023);
+
+    for (i = 0;i + 4 <= n;i += 4) {
+        __m256d x, p, a;
+        __m256i k;
+
+        x = _mm256_loadu_pd(values+i);
+        x = _mm256_min_pd(x, maxlog);
+        x = _mm256_max_pd(x, minlog);
+
+        /* p = floor(x / log2); x -= p * log2; */
+        p = _mm256_floor_pd(_mm256_mul_pd(x, log2e));
+        x = _mm256_fnmadd_pd(p, c1, x);
+        x = _mm256_fnmadd_pd(p, c2, x);
+
+        a = _mm256_set1_pd(3.5524625185478232665958141148891055719216674475023e-8);
+        a = _mm256_fmadd_pd(a, x, _mm256_set1_pd(2.5535368519306500343384723775435166753084614063349e-7));
+        a = _mm256_fmadd_pd(a, x, _mm256_set1_pd(2.77750562801295315877005242757916081614772210463065e-6));
+        a = _mm256_fmadd_pd(a, x, _mm256_set1_pd(2.47868893393199945541176652007657202642495832996107e-5));
+        a = _mm256_fmadd_pd(a, x, _mm256_set1_pd(1.98419213985637881240770890090795533564573406893163e-4));
+        a = _mm256_fmadd_pd(a, x, _mm256_set1_pd(1.3888869684178659239014256260881685824525255547326e-3));
+        a = _mm256_fmadd_pd(a, x, _mm256_set1_pd(8.3333337052009872221152811550156335074160546333973e-3));
+        a = _mm256_fmadd_pd(a, x, _mm256_set1_pd(4.1666666621080810610346717440523105184720007971655e-2));
+        a = _mm256_fmadd_pd(a, x, _mm256_set1_pd(0.166666666669960803484477734308515404418108830469798));
+        a = _mm256_fmadd_pd(a, x, _mm256_set1_pd(0.499999999999877094481580370323249951329122224389189));
+        a = _mm256_fmadd_pd(a, x, _mm256_set1_pd(1.0000000000000017952745258419615282194236357388884));
+        a = _mm256_fmadd_pd(a, x, _mm256_set1_pd(0.99999999999999999566016490920259318691496540598896));
+
+        /* a *= 2^p; */
+        k = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(p));
+        k = _mm256_slli_epi64(_mm256_add_epi64(k, offset), 52);
+        a = _mm256_mul_pd(a, _mm256_castsi256_pd(k));
+
+        _mm256_storeu_pd(values+i, a);
+    }
+    for (;i < n;++i) {
+        values[i] = exp(values[i]);
+    }
+}
+
+AVX2_TARGET static void vecmatvec_t_avx2(double *y, const double *x, const double *A, const int n)
+{
+    /*
+        Columns are computed by blocks of 16, held in registers while the
+        rows of A are streamed, so that y is only written once.
+     */
+    int i, j;
+
+    for (j = 0;j + 16 <= n;j += 16) {
+        __m256d y0 = _mm256_setzero_pd();
+        __m256d y1 = _mm256_setzero_pd();
+        __m256d y2 = _mm256_setzero_pd();
+        __m256d y3 = _mm256_setzero_pd();
+        const double *a = A + j;
+        for (i = 0;i < n;++i, a += n) {
+            const __m256d b = _mm256_broadcast_sd(&x[i]);
+            y0 = _mm256_fmadd_pd(b, _mm256_loadu_pd(a), y0);
+            y1 = _mm256_fmadd_pd(b, _mm256_loadu_pd(a+4), y1);
+            y2 = _mm256_fmadd_pd(b, _mm256_loadu_pd(a+8), y2);
+            y3 = _mm256_fmadd_pd(b, _mm256_loadu_pd(a+12), y3);
+        }
+        _mm256_storeu_pd(y+j, y0);
+        _mm256_storeu_pd(y+j+4, y1);
+        _mm256_storeu_pd(y+j+8, y2);
+        _mm256_storeu_pd(y+j+12, y3);
+    }
+    for (;j < n;j += 4) {
+        const __m256i mask = avx2_mask(n - j);
+        __m256d y0 = _mm256_setzero_pd();
+        const double *a = A + j;
+        for (i = 0;i < n;++i, a += n) {
+            const __m256d b = _mm256_broadcast_sd(&x[i]);
+            y0 = _mm256_fmadd_pd(b, _mm256_maskload_pd(a, mask), y0);
+        }
+        _mm256_maskstore_pd(y+j, mask, y0);
+    }
+}
+
+AVX2_TARGET static void vecmatvec_avx2(double *y, const double *A, const double *x, const int n)
+{
+    /*
+        Rows are computed by blocks of 4, sharing the loads of x, and
+        reduced together at the end of the block.
+     */
+    int i, j;
+    const int tail = n & ~3;
+    const __m256i mask = avx2_mask(n - tail);
+
+    for (i = 0;i + 4 <= n;i += 4) {
+        __m256d s0 = _mm256_setzero_pd();
+        __m256d s1 = _mm256_setzero_pd();
+        __m256d s2 = _mm256_setzero_pd();
+        __m256d s3 = _mm256_setzero_pd();
+        __m256d t0, t1, v;
+        const double *a = A + i * n;
+        for (j = 0;j < tail;j += 4) {
+            v = _mm256_loadu_pd(x+j);
+            s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a+j), v, s0);
+            s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a+n+j), v, s1);
+            s2 = _mm256_fmadd_pd(_mm256_loadu_pd(a+2*n+j), v, s2);
+            s3 = _mm256_fmadd_pd(_mm256_loadu_pd(a+3*n+j), v, s3);
+        }
+        if (tail < n) {
+            v = _mm256_maskload_pd(x+tail, mask);
+            s0 = _mm256_fmadd_pd(_mm256_maskload_pd(a+tail, mask), v, s0);
+            s1 = _mm256_fmadd_pd(_mm256_maskload_pd(a+n+tail, mask), v, s1);
+            s2 = _mm256_fmadd_pd(_mm256_maskload_pd(a+2*n+tail, mask), v, s2);
+            s3 = _mm256_fmadd_pd(_mm256_maskload_pd(a+3*n+tail, mask), v, s3);
+        }
+        /* [sum(s0), sum(s1), sum(s2), sum(s3)] */
+        t0 = _mm256_hadd_pd(s0, s1);
+        t1 = _mm256_hadd_pd(s2, s3);
+        v = _mm256_add_pd(
+            _mm256_permute2f128_pd(t0, t1, 0x20),
+            _mm256_permute2f128_pd(t0, t1, 0x31));
+        _mm256_storeu_pd(y+i, v);
+    }
+    for (;i < n;++i) {
+        __m256d s0 = _mm256_setzero_pd();
+        __m128d h;
+        const double *a = A + i * n;
+        for (j = 0;j < tail;j += 4) {
+            s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a+j), _mm256_loadu_pd(x+j), s0);
+        }
+        if (tail < n) {
+            s0 = _mm256_fmadd_pd(_mm256_maskload_pd(a+tail, mask), _mm256_maskload_pd(x+tail, mask), s0);
+        }
+        h = _mm_add_pd(_mm256_castpd256_pd128(s0), _mm256_extractf128_pd(s0, 1));
+        y[i] = _mm_cvtsd_f64(_mm_add_sd(h, _mm_unpackhi_pd(h, h)));
+    }
+}
+
+AVX2_TARGET static void vecmataadd_avx2(double *M, const double *x, const double *A, const double *y, const int n)
+{
+    int i, j;
+    const int tail = n & ~3;
+    const __m256i mask = avx2_mask(n - tail);
+
+    for (i = 0;i < n;++i) {
+        const __m256d b = _mm256_broadcast_sd(&x[i]);
+        const double *a = A + i * n;
+        double *m = M + i * n;
+        for (j = 0;j < tail;j += 4) {
+            const __m256d ba = _mm256_mul_pd(b, _mm256_loadu_pd(a+j));
+            _mm256_storeu_pd(m+j, _mm256_fmadd_pd(ba, _mm256_loadu_pd(y+j), _mm256_loadu_pd(m+j)));
+        }
+        if (tail < n) {
+            const __m256d ba = _mm256_mul_pd(b, _mm256_maskload_pd(a+tail, mask));
+            const __m256d v = _mm256_fmadd_pd(ba, _mm256_maskload_pd(y+tail, mask), _mm256_maskload_pd(m+tail, mask));
+            _mm256_maskstore_pd(m+tail, mask, v);
+        }
+    }
+}
+
+#endif/*VECMATH_AVX2*/
+
+void vecexp_n(floatval_t *x, const int n)
+{
+    int i;
+#ifdef  VECMATH_AVX2
+    if (cpu_has_avx2()) {
+        vecexp_avx2(x, n);
+        return;
+    }
+#endif
+    for (i = 0;i < n;++i) {
+        x[i] = exp(x[i]);
+    }
+}
+
+void vecmatvec_t(floatval_t *y, const floatval_t *x, const floatval_t *A, const int n)
+{
+    int i;
+#ifdef  VECMATH_AVX2
+    if (cpu_has_avx2()) {
+        vecmatvec_t_avx2(y, x, A, n);
+        return;
+    }
+#endif
+    veczero(y, n);
+    for (i = 0;i < n;++i) {
+        vecaadd(y, x[i], &A[i * n], n);
+    }
+}
+
+void vecmatvec(floatval_t *y, const floatval_t *A, const floatval_t *x, const int n)
+{
+    int i;
+#ifdef  VECMATH_AVX2
+    if (cpu_has_avx2()) {
+        vecmatvec_avx2(y, A, x, n);
+        return;
+    }
+#endif
+    for (i = 0;i < n;++i) {
+        y[i] = vecdot(&A[i * n], x, n);
+    }
+}
+
+void vecmataadd(floatval_t *M, const floatval_t *x, const floatval_t *A, const floatval_t *y, const int n)
+{
+    int i, j;
+#ifdef  VECMATH_AVX2
+    if (cpu_has_avx2()) {
+        vecmataadd_avx2(M, x, A, y, n);
+        return;
+    }
+#endif
+    for (i = 0;i < n;++i) {
+        const floatval_t *a = &A[i * n];
+        floatval_t *m = &M[i * n];
+        for (j = 0;j < n;++j) {
+            m[j] += x[i] * a[j] * y[j];
+        }
+    }
+}
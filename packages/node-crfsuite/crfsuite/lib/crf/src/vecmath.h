@@ -182,6 +182,24 @@ inline static floatval_t vecsumlog(floatval_t* x, const int n)
     return s;
 }
 
+/*
+ * Kernels of the forward-backward algorithm (vecmath.c), using AVX2/FMA
+ * instructions on CPUs that support them. A is a n x n matrix in row-major
+ * order.
+ */
+
+/* x[i] = exp(x[i]), for buffers of any size or alignment. */
+void vecexp_n(floatval_t *x, const int n);
+
+/* y[j] = \sum_{i} x[i] * A[i][j] */
+void vecmatvec_t(floatval_t *y, const floatval_t *x, const floatval_t *A, const int n);
+
+/* y[i] = \sum_{j} A[i][j] * x[j] */
+void vecmatvec(floatval_t *y, const floatval_t *A, const floatval_t *x, const int n);
+
+/* M[i][j] += x[i] * A[i][j] * y[j] */
+void vecmataadd(floatval_t *M, const floatval_t *x, const floatval_t *A, const floatval_t *y, const int n);
+
 #ifdef  USE_SSE
 
 inline static void vecexp(double *values, const int n)
@@ -1,10 +1,49 @@
 export const makeTrainer: (args?: TrainerOptions) => Promise<Trainer>
 export const makeTagger: () => Promise<Tagger>
 
+// attributes of an xseq by id: those of item t are ids[offsets[t]] .. ids[offsets[t + 1] - 1], weighted by weights (1 by default)
+export type AttributeSequence = {
+  ids: Int32Array
+  offsets: Int32Array // xseq.length + 1 entries, starting at 0
+  weights?: Float32Array
+}
+
+export type Xseq = Array<string[]> | AttributeSequence
+
 export declare class Tagger {
-  public tag(xseq: Array<string[]>): { probability: number; result: string[] }
-  public open(model_filename: string): boolean
-  public marginal(xseq: Array<string[]>): { [key: string]: number }[]
+  public tag(xseq: Xseq): { probability: number; result: string[] }
+  // a model given as bytes is read in place, without a copy; it must not be modified while opened
+  public open(model: string | Uint8Array): boolean
+  public marginal(xseq: Xseq): { [key: string]: number }[]
+  // same as tag and marginal, computed on the libuv thread pool; concurrent calls run in parallel on the shared model
+  public tagAsync(xseq: Xseq): Promise<{ probability: number; result: string[] }>
+  public marginalAsync(xseq: Xseq): Promise<{ [key: string]: number }[]>
+  // all marginals from a single forward-backward pass, without an object per position
+  public marginals(xseq: Xseq): MarginalsResult
+  public marginalsAsync(xseq: Xseq): Promise<MarginalsResult>
+  // many sequences in one call, split across `threads` threads [1]
+  public tagBatch(xseqs: Xseq[], threads?: number): Promise<BatchTagResult>
+  public marginalBatch(xseqs: Xseq[], threads?: number): Promise<BatchMarginalResult>
+  // ids of attribute names (without ":weight") in the opened model, -1 for unknown attributes
+  public getAttributeIds(names: string[]): Int32Array
+}
+
+export type MarginalsResult = {
+  labels: string[] // all labels of the model, indexed by label id
+  marginals: Float64Array // marginal of label l at position t at [t * labels.length + l]
+}
+
+export type BatchTagResult = {
+  labels: string[] // all labels of the model, indexed by label id
+  offsets: Int32Array // positions of sequence i are [offsets[i], offsets[i + 1])
+  ids: Int32Array // label id of every position
+  probabilities: Float64Array // path probability of every sequence
+}
+
+export type BatchMarginalResult = {
+  labels: string[]
+  offsets: Int32Array
+  marginals: Float64Array // marginal of label l at position p at [p * labels.length + l]
 }
 
 export type Options = {
@@ -18,7 +57,11 @@ export type TrainerOptions = {
 
 export declare class Trainer {
   constructor(opts?: TrainerOptions)
-  public append(xseq: Array<string[]>, yseq: string[]): void
+  public append(xseq: Xseq, yseq: string[]): void
+  // appends all sequences or none of them, with their storage reserved at once
+  public append_batch(xseqs: Xseq[], yseqs: string[][]): void
+  // ids of attribute names in the training data, added when new; they differ from the ids of the trained model
+  public get_attribute_ids(names: string[]): Int32Array
   public train(model_filename: string, cb?: (iteration: number) => number | undefined): number
   public train_async(model_filename: string, cb?: (iteration: number) => number | undefined): Promise<number>
   public get_params(options: Options): any
@@ -7,12 +7,16 @@
                 "fastText/src/args.h",
                 "fastText/src/autotune.cc",
                 "fastText/src/autotune.h",
+                "fastText/src/corpus.cc",
+                "fastText/src/corpus.h",
                 "fastText/src/densematrix.cc",
                 "fastText/src/densematrix.h",
                 "fastText/src/dictionary.cc",
                 "fastText/src/dictionary.h",
                 "fastText/src/fasttext.cc",
                 "fastText/src/fasttext.h",
+                "fastText/src/halfmatrix.cc",
+                "fastText/src/halfmatrix.h",
                 "fastText/src/loss.cc",
                 "fastText/src/loss.h",
                 "fastText/src/main.cc",
@@ -27,8 +31,12 @@
                 "fastText/src/quantmatrix.cc",
                 "fastText/src/quantmatrix.h",
                 "fastText/src/real.h",
+                "fastText/src/stagedmatrix.cc",
+                "fastText/src/stagedmatrix.h",
                 "fastText/src/utils.cc",
                 "fastText/src/utils.h",
+                "fastText/src/vecmath.cc",
+                "fastText/src/vecmath.h",
                 "fastText/src/vector.cc",
                 "fastText/src/vector.h",
                 "cppsrc/node-util.cc",
@@ -37,6 +45,8 @@
                 "cppsrc/train.cc",
                 "cppsrc/quantize.cc",
                 "cppsrc/predictWorker.cc",
+                "cppsrc/predictBatchWorker.cc",
+                "cppsrc/idsWorker.cc",
                 "cppsrc/nnWorker.cc",
                 "cppsrc/wrapper.cc",
                 "cppsrc/classifier.cc",
@@ -44,11 +54,18 @@
                 "cppsrc/addon.cc",
                 "cppsrc/binding-utils.cc",
                 "cppsrc/vecWorker.cc",
+                "cppsrc/prewarmWorker.cc",
+                "cppsrc/sentenceVectorsWorker.cc",
+                "cppsrc/autotuneWorker.cc",
                 "cppsrc/fasttext_napi.cc",
-                "cppsrc/fasttext_napi.h"
+                "cppsrc/fasttext_napi.h",
+                "cppsrc/model-registry.cc",
+                "cppsrc/model-registry.h",
+                "cppsrc/subword-cache.cc",
+                "cppsrc/subword-cache.h"
             ],
             "defines": [
-                "NAPI_VERSION=3",
+                "NAPI_VERSION=4",
             ],
             "include_dirs": [
                 "<!@(node -p \"require('node-addon-api').include\")"
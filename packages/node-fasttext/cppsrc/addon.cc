@@ -2,11 +2,27 @@
 #include <napi.h>
 #include "classifier.h"
 #include "query.h"
+#include "model-registry.h"
+
+Napi::Value Prefetch(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+
+  if (info.Length() == 0 || !info[0].IsString())
+  {
+    Napi::TypeError::New(env, "Path to model file is missing!").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  std::string filename = info[0].As<Napi::String>().Utf8Value();
+  return Napi::Number::New(env, ModelRegistry::prefetch(filename));
+}
 
 Napi::Object Initialize(Napi::Env env, Napi::Object exports)
 {
   FasttextClassifier::Init(env, exports);
   FasttextQuery::Init(env, exports);
+  exports.Set("prefetch", Napi::Function::New(env, Prefetch));
   return exports;
 }
 
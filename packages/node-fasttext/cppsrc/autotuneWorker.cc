@@ -0,0 +1,61 @@
+#include "autotuneWorker.h"
+#include "node-argument.h"
+
+void AutotuneWorker::Execute()
+{
+  try
+  {
+    result_ = wrapper_->autotune(args_,
+                                 hasCorpus_ ? &corpus_ : nullptr,
+                                 hasValidation_ ? &validation_ : nullptr,
+                                 toBuffer_ ? &model_ : nullptr,
+                                 {},
+                                 aborted_);
+    corpus_.clear();
+    corpus_.shrink_to_fit();
+    validation_.clear();
+    validation_.shrink_to_fit();
+  }
+  catch (std::string errorMessage)
+  {
+    SetError(errorMessage.c_str());
+  }
+  catch (const char *str)
+  {
+    SetError(str);
+  }
+  catch (const std::exception &e)
+  {
+    SetError(e.what());
+  }
+}
+
+void AutotuneWorker::OnError(const Napi::Error &e)
+{
+  Napi::HandleScope scope(Env());
+  Napi::String error = Napi::String::New(Env(), e.Message());
+  deferred_.Reject(error);
+
+  // Call empty function
+  Callback().Call({error});
+}
+
+void AutotuneWorker::OnOK()
+{
+  Napi::Env env = Env();
+  Napi::HandleScope scope(env);
+
+  NodeArgument::NodeArgument nodeArg;
+  Napi::Object result = nodeArg.mapToNapiObject(env, result_);
+  if (toBuffer_)
+  {
+    result.Set(Napi::String::New(env, "model"), Napi::Buffer<char>::Copy(env, model_.data(), model_.size()));
+  }
+  deferred_.Resolve(result);
+
+  // Call empty function
+  if (!Callback().IsEmpty())
+  {
+    Callback().Call({env.Null(), result});
+  }
+}
@@ -0,0 +1,70 @@
+#ifndef AUTOTUNE_WORKER_H
+#define AUTOTUNE_WORKER_H
+
+#include <napi.h>
+#include "wrapper.h"
+
+class AutotuneWorker : public Napi::AsyncWorker
+{
+public:
+  AutotuneWorker(const std::vector<std::string> args, Wrapper *wrapper, Napi::Promise::Deferred deferred, Napi::Function &callback)
+      : Napi::AsyncWorker(callback),
+        deferred_(deferred),
+        args_(args),
+        wrapper_(wrapper),
+        aborted_(wrapper->newJob()),
+        result_(),
+        hasCorpus_(false),
+        hasValidation_(false),
+        toBuffer_(false){};
+
+  ~AutotuneWorker(){};
+
+  /**
+   * Trains from an in-memory corpus (one example per line) instead of args' input file.
+   */
+  void SetCorpus(std::string corpus)
+  {
+    corpus_ = std::move(corpus);
+    hasCorpus_ = true;
+  }
+
+  /**
+   * Scores the trials on an in-memory validation set instead of args' autotune-validation file.
+   */
+  void SetValidation(std::string validation)
+  {
+    validation_ = std::move(validation);
+    hasValidation_ = true;
+  }
+
+  /**
+   * Resolves with the serialized model in `model` instead of writing model files.
+   */
+  void SetOutputToBuffer()
+  {
+    toBuffer_ = true;
+  }
+
+  Napi::Promise::Deferred deferred_;
+
+  void Execute();
+  void OnOK();
+  void OnError(const Napi::Error &e);
+
+private:
+  const std::vector<std::string> args_;
+  Wrapper *wrapper_;
+  // Set by the classifier's cancel() from the moment the job is queued.
+  AbortFlag aborted_;
+  std::map<std::string, std::string> result_;
+
+  bool hasCorpus_;
+  std::string corpus_;
+  bool hasValidation_;
+  std::string validation_;
+  bool toBuffer_;
+  std::string model_;
+};
+
+#endif
@@ -15,4 +15,58 @@ Napi::Array napi_utils::arrayToNapi(Napi::Env env, std::vector<double> array, un
   }
 
   return napiArray;
-}
\ No newline at end of file
+}
+
+Napi::Object napi_utils::progressToNapi(Napi::Env env, const TrainProgress &progress)
+{
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set(Napi::String::New(env, "progress"), Napi::Number::New(env, progress.progress));
+  obj.Set(Napi::String::New(env, "loss"), Napi::Number::New(env, progress.loss));
+  obj.Set(Napi::String::New(env, "wordsPerSecPerThread"), Napi::Number::New(env, progress.wordsPerSecPerThread));
+  obj.Set(Napi::String::New(env, "lr"), Napi::Number::New(env, progress.lr));
+  obj.Set(Napi::String::New(env, "eta"), Napi::Number::New(env, progress.eta));
+  return obj;
+}
+
+bool napi_utils::stringsFromNapi(Napi::Value value, std::vector<std::string> &strings)
+{
+  if (!value.IsArray())
+  {
+    return false;
+  }
+  Napi::Array array = value.As<Napi::Array>();
+  strings.clear();
+  strings.reserve(array.Length());
+  for (uint32_t i = 0; i < array.Length(); i++)
+  {
+    Napi::Value item = array.Get(i);
+    if (!item.IsString())
+    {
+      return false;
+    }
+    strings.push_back(item.As<Napi::String>().Utf8Value());
+  }
+  return true;
+}
+
+bool napi_utils::corpusFromNapi(Napi::Value value, std::string &corpus)
+{
+  corpus.clear();
+  if (value.IsBuffer())
+  {
+    Napi::Buffer<char> buffer = value.As<Napi::Buffer<char>>();
+    corpus.assign(buffer.Data(), buffer.Length());
+    return true;
+  }
+  if (value.IsArray())
+  {
+    Napi::Array lines = value.As<Napi::Array>();
+    for (uint32_t i = 0; i < lines.Length(); i++)
+    {
+      corpus += lines.Get(i).ToString().Utf8Value();
+      corpus += '\n';
+    }
+    return true;
+  }
+  return false;
+}
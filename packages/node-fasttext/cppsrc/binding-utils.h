@@ -2,8 +2,16 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include "wrapper.h"
 
 namespace napi_utils
 {
   Napi::Array arrayToNapi(Napi::Env env, std::vector<double> array, unsigned int array_size);
+  Napi::Object progressToNapi(Napi::Env env, const TrainProgress &progress);
+  bool stringsFromNapi(Napi::Value value, std::vector<std::string> &strings);
+
+  /**
+   * Reads an in-memory corpus given as a Buffer or as an array of lines.
+   */
+  bool corpusFromNapi(Napi::Value value, std::string &corpus);
 }
\ No newline at end of file
@@ -1,8 +1,12 @@
 #include "classifier.h"
 #include "loadModel.h"
 #include "predictWorker.h"
+#include "predictBatchWorker.h"
+#include "idsWorker.h"
+#include "binding-utils.h"
 #include "train.h"
 #include "quantize.h"
+#include "autotuneWorker.h"
 #include <iostream>
 
 Napi::FunctionReference FasttextClassifier::constructor;
@@ -13,8 +17,12 @@ Napi::Object FasttextClassifier::Init(Napi::Env env, Napi::Object exports)
   Napi::Function func = DefineClass(env, "FasttextClassifier",
                                     {InstanceMethod("loadModel", &FasttextClassifier::LoadModel),
                                      InstanceMethod("predict", &FasttextClassifier::Predict),
+                                     InstanceMethod("getIds", &FasttextClassifier::GetIds),
+                                     InstanceMethod("predictBatch", &FasttextClassifier::PredictBatch),
                                      InstanceMethod("train", &FasttextClassifier::Train),
-                                     InstanceMethod("quantize", &FasttextClassifier::Quantize)});
+                                     InstanceMethod("quantize", &FasttextClassifier::Quantize),
+                                     InstanceMethod("autotune", &FasttextClassifier::Autotune),
+                                     InstanceMethod("cancel", &FasttextClassifier::Cancel)});
 
   constructor = Napi::Persistent(func);
   constructor.SuppressDestruct();
@@ -52,9 +60,20 @@ Napi::Value FasttextClassifier::LoadModel(const Napi::CallbackInfo &info)
     Napi::TypeError::New(env, "Model file path must be a string!").ThrowAsJavaScriptException();
   }
 
-  if (info.Length() > 1 && info[1].IsFunction())
+  size_t callbackIndex = 1;
+  if (info.Length() > 1 && info[1].IsObject() && !info[1].IsFunction())
   {
-    callback = info[1].As<Napi::Function>();
+    Napi::Object options = info[1].As<Napi::Object>();
+    if (options.Has("loadThreads") && options.Get("loadThreads").IsNumber())
+    {
+      this->wrapper_->setLoadThreads(options.Get("loadThreads").As<Napi::Number>().Int32Value());
+    }
+    callbackIndex = 2;
+  }
+
+  if (info.Length() > callbackIndex && info[callbackIndex].IsFunction())
+  {
+    callback = info[callbackIndex].As<Napi::Function>();
   }
   else
   {
@@ -80,9 +99,12 @@ Napi::Value FasttextClassifier::Predict(const Napi::CallbackInfo &info)
   ;
   int32_t k = 1;
 
-  if (info.Length() < 1 || !info[0].IsString())
+  bool isIds = info.Length() > 0 && info[0].IsTypedArray() &&
+               info[0].As<Napi::TypedArray>().TypedArrayType() == napi_int32_array;
+
+  if (info.Length() < 1 || !(info[0].IsString() || isIds))
   {
-    Napi::TypeError::New(env, "sentence must be a string").ThrowAsJavaScriptException();
+    Napi::TypeError::New(env, "sentence must be a string or an Int32Array of ids").ThrowAsJavaScriptException();
   }
 
   if (info.Length() > 1 && info[1].IsNumber())
@@ -96,6 +118,18 @@ Napi::Value FasttextClassifier::Predict(const Napi::CallbackInfo &info)
   }
 
   Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(info.Env());
+
+  if (isIds)
+  {
+    Napi::Int32Array napiIds = info[0].As<Napi::Int32Array>();
+    std::vector<int32_t> ids(napiIds.Data(), napiIds.Data() + napiIds.ElementLength());
+
+    PredictWorker *worker = new PredictWorker(ids, k, this->wrapper_, deferred, callback);
+    worker->Queue();
+
+    return worker->deferred_.Promise();
+  }
+
   Napi::String sentence = info[0].As<Napi::String>();
 
   PredictWorker *worker = new PredictWorker(sentence, k, this->wrapper_, deferred, callback);
@@ -104,6 +138,83 @@ Napi::Value FasttextClassifier::Predict(const Napi::CallbackInfo &info)
   return worker->deferred_.Promise();
 }
 
+Napi::Value FasttextClassifier::GetIds(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  Napi::HandleScope scope(env);
+
+  std::vector<std::string> tokens;
+  if (info.Length() == 0 || !napi_utils::stringsFromNapi(info[0], tokens))
+  {
+    Napi::TypeError::New(env, "tokens must be an array of strings").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Function callback = Napi::Function::New(env, EmptyCallback);
+  if (info.Length() > 1 && info[1].IsFunction())
+  {
+    callback = info[1].As<Napi::Function>();
+  }
+
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(info.Env());
+
+  IdsWorker *worker = new IdsWorker(tokens, this->wrapper_, deferred, callback);
+  worker->Queue();
+
+  return worker->deferred_.Promise();
+}
+
+Napi::Value FasttextClassifier::PredictBatch(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  Napi::HandleScope scope(env);
+  Napi::Function callback = Napi::Function::New(env, EmptyCallback);
+  int32_t k = 1;
+  int32_t nthreads = 1;
+
+  if (info.Length() < 1 || !info[0].IsArray())
+  {
+    Napi::TypeError::New(env, "sentences must be an array of strings").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (info.Length() > 1 && info[1].IsNumber())
+  {
+    k = info[1].As<Napi::Number>().Int32Value();
+  }
+
+  if (info.Length() > 2 && info[2].IsNumber())
+  {
+    nthreads = info[2].As<Napi::Number>().Int32Value();
+  }
+
+  if (info.Length() > 3 && info[3].IsFunction())
+  {
+    callback = info[3].As<Napi::Function>();
+  }
+
+  Napi::Array napiSentences = info[0].As<Napi::Array>();
+  std::vector<std::string> sentences;
+  sentences.reserve(napiSentences.Length());
+  for (uint32_t i = 0; i < napiSentences.Length(); i++)
+  {
+    Napi::Value sentence = napiSentences.Get(i);
+    if (!sentence.IsString())
+    {
+      Napi::TypeError::New(env, "sentences must be an array of strings").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    sentences.push_back(sentence.As<Napi::String>().Utf8Value());
+  }
+
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(info.Env());
+
+  PredictBatchWorker *worker = new PredictBatchWorker(sentences, k, nthreads, this->wrapper_, deferred, callback);
+  worker->Queue();
+
+  return worker->deferred_.Promise();
+}
+
 Napi::Value FasttextClassifier::Train(const Napi::CallbackInfo &info)
 {
   Napi::Env env = info.Env();
@@ -130,6 +241,12 @@ Napi::Value FasttextClassifier::Train(const Napi::CallbackInfo &info)
     callback = info[2].As<Napi::Function>();
   }
 
+  Napi::Function progressCallback;
+  if (info.Length() > 3 && info[3].IsFunction())
+  {
+    progressCallback = info[3].As<Napi::Function>();
+  }
+
   std::string command = info[0].As<Napi::String>().Utf8Value();
 
   if (!(command == "cbow" || command == "quantize" || command == "skipgram" || command == "supervised"))
@@ -141,9 +258,40 @@ Napi::Value FasttextClassifier::Train(const Napi::CallbackInfo &info)
   NodeArgument::NodeArgument nodeArg;
   NodeArgument::CArgument c_argument;
 
+  // `input` may hold the corpus itself (Buffer or array of lines) and a missing
+  // `output` asks for the model as a Buffer; neither is a fastText argument.
+  Napi::Object confObj = info[1].As<Napi::Object>();
+  Napi::Value input = confObj.Get("input");
+  bool hasCorpus = input.IsBuffer() || input.IsArray();
+  bool toBuffer = !confObj.Has("output") || confObj.Get("output").IsUndefined();
+  std::string corpus;
+
+  if (hasCorpus || toBuffer)
+  {
+    if (command == "quantize")
+    {
+      Napi::TypeError::New(env, "quantize requires input and output files").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    napi_utils::corpusFromNapi(input, corpus);
+
+    Napi::Object filtered = Napi::Object::New(env);
+    Napi::Array props = confObj.GetPropertyNames();
+    for (uint32_t i = 0; i < props.Length(); i++)
+    {
+      std::string key = props.Get(i).As<Napi::String>().Utf8Value();
+      if ((hasCorpus && key == "input") || (toBuffer && key == "output"))
+      {
+        continue;
+      }
+      filtered.Set(key, confObj.Get(key));
+    }
+    confObj = filtered;
+  }
+
   try
   {
-    Napi::Object confObj = info[1].As<Napi::Object>();
     c_argument = nodeArg.NapiObjectToCArgument(env, confObj);
   }
   catch (std::string errorMessage)
@@ -163,15 +311,43 @@ Napi::Value FasttextClassifier::Train(const Napi::CallbackInfo &info)
     args.push_back(argument[j]);
   }
 
+  // fastText requires both paths to be set even when they are not used.
+  if (hasCorpus)
+  {
+    args.push_back("-input");
+    args.push_back("<memory>");
+  }
+  if (toBuffer)
+  {
+    args.push_back("-output");
+    args.push_back("<memory>");
+  }
+
   if (command == "quantize")
   {
     QuantizeWorker *worker = new QuantizeWorker(args, this->wrapper_, deferred, callback);
+    if (!progressCallback.IsEmpty())
+    {
+      worker->SetProgressCallback(progressCallback);
+    }
     worker->Queue();
     return worker->deferred_.Promise();
   }
   else
   {
     TrainWorker *worker = new TrainWorker(args, this->wrapper_, deferred, callback);
+    if (!progressCallback.IsEmpty())
+    {
+      worker->SetProgressCallback(progressCallback);
+    }
+    if (hasCorpus)
+    {
+      worker->SetCorpus(std::move(corpus));
+    }
+    if (toBuffer)
+    {
+      worker->SetOutputToBuffer();
+    }
     worker->Queue();
     return worker->deferred_.Promise();
   }
@@ -195,6 +371,12 @@ Napi::Value FasttextClassifier::Quantize(const Napi::CallbackInfo &info)
     callback = info[1].As<Napi::Function>();
   }
 
+  Napi::Function progressCallback;
+  if (info.Length() > 2 && info[2].IsFunction())
+  {
+    progressCallback = info[2].As<Napi::Function>();
+  }
+
   Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(info.Env());
   NodeArgument::NodeArgument nodeArg;
   NodeArgument::CArgument c_argument;
@@ -222,7 +404,137 @@ Napi::Value FasttextClassifier::Quantize(const Napi::CallbackInfo &info)
   }
 
   QuantizeWorker *worker = new QuantizeWorker(args, this->wrapper_, deferred, callback);
+  if (!progressCallback.IsEmpty())
+  {
+    worker->SetProgressCallback(progressCallback);
+  }
   worker->Queue();
 
   return worker->deferred_.Promise();
 }
+
+Napi::Value FasttextClassifier::Autotune(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  Napi::HandleScope scope(env);
+  Napi::Function callback = Napi::Function::New(env, EmptyCallback);
+
+  if (info.Length() < 1 || !info[0].IsObject())
+  {
+    Napi::TypeError::New(env, "options must be an object").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (info.Length() > 1 && info[1].IsFunction())
+  {
+    callback = info[1].As<Napi::Function>();
+  }
+
+  // Like train, `input` and `validation` may hold the data itself, and the
+  // autotune options are mapped to their fastText `-autotune-*` arguments.
+  Napi::Object confObj = info[0].As<Napi::Object>();
+  Napi::Value input = confObj.Get("input");
+  Napi::Value validation = confObj.Get("validation");
+  bool hasCorpus = input.IsBuffer() || input.IsArray();
+  bool hasValidation = validation.IsBuffer() || validation.IsArray();
+  bool toBuffer = !confObj.Has("output") || confObj.Get("output").IsUndefined();
+  std::string corpus;
+  std::string validationCorpus;
+  napi_utils::corpusFromNapi(input, corpus);
+  napi_utils::corpusFromNapi(validation, validationCorpus);
+
+  if (!hasValidation && !validation.IsString())
+  {
+    Napi::TypeError::New(env, "validation must be a file path, an array of lines or a Buffer").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  const std::map<std::string, std::string> autotuneOptions = {
+      {"validation", "-autotune-validation"},
+      {"duration", "-autotune-duration"},
+      {"modelSize", "-autotune-modelsize"},
+      {"metric", "-autotune-metric"},
+      {"predictions", "-autotune-predictions"}};
+
+  std::vector<std::string> args;
+  args.push_back("-command");
+  args.push_back("supervised");
+
+  Napi::Object filtered = Napi::Object::New(env);
+  Napi::Array props = confObj.GetPropertyNames();
+  for (uint32_t i = 0; i < props.Length(); i++)
+  {
+    std::string key = props.Get(i).As<Napi::String>().Utf8Value();
+    auto option = autotuneOptions.find(key);
+    if (option != autotuneOptions.end())
+    {
+      if (!(key == "validation" && hasValidation))
+      {
+        args.push_back(option->second);
+        args.push_back(confObj.Get(key).ToString().Utf8Value());
+      }
+    }
+    else if (!(hasCorpus && key == "input") && !(toBuffer && key == "output"))
+    {
+      filtered.Set(key, confObj.Get(key));
+    }
+  }
+
+  NodeArgument::NodeArgument nodeArg;
+  NodeArgument::CArgument c_argument;
+  try
+  {
+    c_argument = nodeArg.NapiObjectToCArgument(env, filtered);
+  }
+  catch (std::string errorMessage)
+  {
+    Napi::TypeError::New(env, errorMessage.c_str()).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  for (size_t j = 0; j < c_argument.argc; j++)
+  {
+    args.push_back(c_argument.argv[j]);
+  }
+
+  // fastText requires the paths to be set even when they are not used.
+  if (hasCorpus)
+  {
+    args.push_back("-input");
+    args.push_back("<memory>");
+  }
+  if (hasValidation)
+  {
+    args.push_back("-autotune-validation");
+    args.push_back("<memory>");
+  }
+  if (toBuffer)
+  {
+    args.push_back("-output");
+    args.push_back("<memory>");
+  }
+
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(info.Env());
+  AutotuneWorker *worker = new AutotuneWorker(args, this->wrapper_, deferred, callback);
+  if (hasCorpus)
+  {
+    worker->SetCorpus(std::move(corpus));
+  }
+  if (hasValidation)
+  {
+    worker->SetValidation(std::move(validationCorpus));
+  }
+  if (toBuffer)
+  {
+    worker->SetOutputToBuffer();
+  }
+  worker->Queue();
+  return worker->deferred_.Promise();
+}
+
+Napi::Value FasttextClassifier::Cancel(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  this->wrapper_->abort();
+  return env.Undefined();
+}
@@ -25,8 +25,12 @@ private:
 
   Napi::Value LoadModel(const Napi::CallbackInfo &info);
   Napi::Value Predict(const Napi::CallbackInfo &info);
+  Napi::Value PredictBatch(const Napi::CallbackInfo &info);
+  Napi::Value GetIds(const Napi::CallbackInfo &info);
   Napi::Value Train(const Napi::CallbackInfo &info);
   Napi::Value Quantize(const Napi::CallbackInfo &info);
+  Napi::Value Autotune(const Napi::CallbackInfo &info);
+  Napi::Value Cancel(const Napi::CallbackInfo &info);
 
   Wrapper *wrapper_;
 };
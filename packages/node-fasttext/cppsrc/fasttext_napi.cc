@@ -3,13 +3,24 @@
 ModelInfo FastTextNapi::loadAndGetModel(const std::string &filename)
 {
   FastText::loadModel(filename);
-  return {model_, args_, dict_};
+  return {model_, args_, dict_, input_};
 }
 
-ModelInfo FastTextNapi::loadAndGetModel(std::istream &in)
+ModelInfo FastTextNapi::loadAndGetModel(std::istream &in, storage_type inputStorage)
 {
-  FastText::loadModel(in);
-  return {model_, args_, dict_};
+  FastText::loadModel(in, inputStorage);
+  return {model_, args_, dict_, input_};
+}
+
+ModelInfo FastTextNapi::loadAndGetModel(std::istream &in, storage_type inputStorage, const std::string &filename, int32_t nthreads)
+{
+  FastText::loadModel(in, inputStorage, filename, nthreads);
+  return {model_, args_, dict_, input_};
+}
+
+ModelInfo FastTextNapi::getModelInfo() const
+{
+  return {model_, args_, dict_, input_};
 }
 
 void FastTextNapi::saveModel()
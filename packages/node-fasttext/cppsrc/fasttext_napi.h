@@ -1,8 +1,11 @@
+#ifndef FASTTEXT_NAPI_H
+#define FASTTEXT_NAPI_H
 
 #include "../fastText/src/fasttext.h"
 
 #include "../fastText/src/args.h"
 #include "../fastText/src/densematrix.h"
+#include "../fastText/src/halfmatrix.h"
 #include "../fastText/src/quantmatrix.h"
 #include "../fastText/src/dictionary.h"
 #include "../fastText/src/matrix.h"
@@ -18,7 +21,11 @@ class FastTextNapi : public FastText
 {
 public:
   struct ModelInfo loadAndGetModel(const std::string &filename);
-  struct ModelInfo loadAndGetModel(std::istream &in);
+  struct ModelInfo loadAndGetModel(std::istream &in, storage_type inputStorage = storage_type::fp32);
+  struct ModelInfo loadAndGetModel(std::istream &in, storage_type inputStorage, const std::string &filename, int32_t nthreads);
+  struct ModelInfo getModelInfo() const;
+
+  using FastText::saveModel;
 
   void saveVectors();
   void saveModel();
@@ -29,4 +36,7 @@ struct ModelInfo
   std::shared_ptr<Model> model;
   std::shared_ptr<Args> args;
   std::shared_ptr<Dictionary> dict;
+  std::shared_ptr<const Matrix> input;
 };
+
+#endif
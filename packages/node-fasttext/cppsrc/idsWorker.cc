@@ -0,0 +1,50 @@
+#include "idsWorker.h"
+
+#include <algorithm>
+
+void IdsWorker::Execute()
+{
+  try
+  {
+    wrapper_->loadModel();
+    result_ = wrapper_->getIds(tokens_);
+  }
+  catch (std::string errorMessage)
+  {
+    SetError(errorMessage.c_str());
+  }
+  catch (const char *str)
+  {
+    SetError(str);
+  }
+  catch (const std::exception &e)
+  {
+    SetError(e.what());
+  }
+}
+
+void IdsWorker::OnError(const Napi::Error &e)
+{
+  Napi::HandleScope scope(Env());
+  Napi::String error = Napi::String::New(Env(), e.Message());
+  deferred_.Reject(error);
+
+  // Call empty function
+  Callback().Call({error});
+}
+
+void IdsWorker::OnOK()
+{
+  Napi::Env env = Env();
+  Napi::HandleScope scope(env);
+  Napi::Int32Array result = Napi::Int32Array::New(env, result_.size());
+  std::copy(result_.begin(), result_.end(), result.Data());
+
+  deferred_.Resolve(result);
+
+  // Call empty function
+  if (!Callback().IsEmpty())
+  {
+    Callback().Call({env.Null(), result});
+  }
+}
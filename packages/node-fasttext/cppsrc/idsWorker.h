@@ -0,0 +1,35 @@
+#ifndef IDS_WORKER_H
+#define IDS_WORKER_H
+
+#include <napi.h>
+#include "wrapper.h"
+
+class IdsWorker : public Napi::AsyncWorker
+{
+public:
+  IdsWorker(
+      std::vector<std::string> tokens,
+      Wrapper *wrapper,
+      Napi::Promise::Deferred deferred,
+      Napi::Function &callback)
+      : Napi::AsyncWorker(callback),
+        deferred_(deferred),
+        tokens_(std::move(tokens)),
+        wrapper_(wrapper),
+        result_(){};
+
+  ~IdsWorker(){};
+
+  Napi::Promise::Deferred deferred_;
+
+  void Execute();
+  void OnOK();
+  void OnError(const Napi::Error &e);
+
+private:
+  std::vector<std::string> tokens_;
+  Wrapper *wrapper_;
+  std::vector<int32_t> result_;
+};
+
+#endif
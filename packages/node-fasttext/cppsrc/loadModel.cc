@@ -16,6 +16,10 @@ void LoadModelWorker::Execute()
   {
     SetError(errorMessage.c_str());
   }
+  catch (const std::exception &e)
+  {
+    SetError(e.what());
+  }
 }
 
 void LoadModelWorker::OnOK()
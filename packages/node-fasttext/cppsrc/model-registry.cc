@@ -0,0 +1,173 @@
+#include "model-registry.h"
+
+#include <sys/stat.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#include <algorithm>
+
+#ifdef _WIN32
+#define stat _stat
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+ModelRegistry &ModelRegistry::getInstance()
+{
+  // Intentionally leaked: models may outlive static destruction at exit.
+  static ModelRegistry *instance = new ModelRegistry();
+  return *instance;
+}
+
+std::string ModelRegistry::makeKey(const std::string &filename)
+{
+  std::string path = filename;
+#ifdef _WIN32
+  char resolved[_MAX_PATH];
+  if (_fullpath(resolved, filename.c_str(), _MAX_PATH) != NULL)
+  {
+    path = resolved;
+  }
+#else
+  char resolved[PATH_MAX];
+  if (realpath(filename.c_str(), resolved) != NULL)
+  {
+    path = resolved;
+  }
+#endif
+
+  struct stat info;
+  if (stat(path.c_str(), &info) != 0)
+  {
+    return path;
+  }
+  return path + ":" + std::to_string((long long)info.st_mtime) + ":" + std::to_string((long long)info.st_size);
+}
+
+std::shared_ptr<const FastTextNapi> ModelRegistry::acquire(const std::string &filename,
+                                                           const Loader &loader,
+                                                           const std::string &variant)
+{
+  const std::string key = variant.empty() ? makeKey(filename) : makeKey(filename) + ":" + variant;
+
+  std::shared_ptr<Slot> slot;
+  std::unique_lock<std::mutex> lock;
+  std::shared_ptr<const FastTextNapi> model;
+  for (;;)
+  {
+    {
+      std::lock_guard<std::mutex> registryLock(mtx_);
+      std::shared_ptr<Slot> &entry = slots_[key];
+      if (!entry)
+      {
+        entry = std::make_shared<Slot>();
+      }
+      slot = entry;
+    }
+
+    // Only loads of the same file are serialized; distinct models load concurrently.
+    lock = std::unique_lock<std::mutex>(slot->mtx);
+    model = slot->model.lock();
+    if (model)
+    {
+      return model;
+    }
+
+    // The slot may have been dropped by release() while this call waited for it.
+    std::lock_guard<std::mutex> registryLock(mtx_);
+    auto it = slots_.find(key);
+    if (it != slots_.end() && it->second == slot)
+    {
+      break;
+    }
+    lock.unlock();
+  }
+
+  FastTextNapi *fastText = new FastTextNapi();
+  try
+  {
+    loader(*fastText, filename);
+  }
+  catch (...)
+  {
+    delete fastText;
+    lock.unlock();
+    slot.reset();
+    release(key);
+    throw;
+  }
+
+  model = std::shared_ptr<const FastTextNapi>(fastText, [this, key](const FastTextNapi *ptr) {
+    delete ptr;
+    release(key);
+  });
+  slot->model = model;
+  return model;
+}
+
+void ModelRegistry::release(const std::string &key)
+{
+  std::shared_ptr<Slot> slot;
+  {
+    std::lock_guard<std::mutex> registryLock(mtx_);
+    auto it = slots_.find(key);
+    if (it == slots_.end())
+    {
+      return;
+    }
+    slot = it->second;
+  }
+
+  // Another caller may load the file again into the slot once its model was
+  // deleted; the slot is only dropped while it holds no model. Slots are
+  // locked before the registry, as in acquire, and without holding the
+  // registry while a load of the file runs.
+  std::lock_guard<std::mutex> slotLock(slot->mtx);
+  if (!slot->model.expired())
+  {
+    return;
+  }
+  std::lock_guard<std::mutex> registryLock(mtx_);
+  auto it = slots_.find(key);
+  if (it != slots_.end() && it->second == slot)
+  {
+    slots_.erase(it);
+  }
+}
+
+size_t ModelRegistry::size()
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+  return slots_.size();
+}
+
+int64_t ModelRegistry::prefetch(const std::string &filename)
+{
+  struct stat info;
+  if (stat(filename.c_str(), &info) != 0)
+  {
+    return -1;
+  }
+#if defined(POSIX_FADV_WILLNEED)
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return -1;
+  }
+  posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+  close(fd);
+#elif defined(F_RDADVISE)
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return -1;
+  }
+  struct radvisory advice;
+  advice.ra_offset = 0;
+  advice.ra_count = (int)std::min<int64_t>(info.st_size, INT_MAX);
+  fcntl(fd, F_RDADVISE, &advice);
+  close(fd);
+#endif
+  return info.st_size;
+}
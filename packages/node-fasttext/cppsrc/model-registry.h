@@ -0,0 +1,61 @@
+#ifndef MODEL_REGISTRY_H
+#define MODEL_REGISTRY_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "./fasttext_napi.h"
+
+/**
+ * Process-wide cache of loaded fastText models.
+ *
+ * Models are keyed by canonical file path, modification time and size, so the
+ * same file opened by several Classifier/Query instances is only held once in
+ * memory, while a model overwritten on disk is loaded again. The variant tells
+ * apart different in-memory representations of one file (e.g. fp16 storage). Handles are
+ * reference counted: the model is released when the last one goes away.
+ *
+ * Models handed out by the registry are shared and must be treated as
+ * read-only; training and quantization work on a private FastTextNapi.
+ */
+class ModelRegistry
+{
+public:
+  typedef std::function<void(FastTextNapi &, const std::string &)> Loader;
+
+  static ModelRegistry &getInstance();
+
+  std::shared_ptr<const FastTextNapi> acquire(const std::string &filename,
+                                              const Loader &loader,
+                                              const std::string &variant = "");
+  size_t size();
+
+  /**
+   * Asks the OS to read the file into its page cache in the background, so a
+   * later load reads from memory. Returns at once with the size of the file,
+   * or -1 when it cannot be opened.
+   */
+  static int64_t prefetch(const std::string &filename);
+
+private:
+  struct Slot
+  {
+    std::mutex mtx;
+    std::weak_ptr<const FastTextNapi> model;
+  };
+
+  ModelRegistry(){};
+  ModelRegistry(const ModelRegistry &) = delete;
+  ModelRegistry &operator=(const ModelRegistry &) = delete;
+
+  std::string makeKey(const std::string &filename);
+  void release(const std::string &key);
+
+  std::mutex mtx_;
+  std::map<std::string, std::shared_ptr<Slot>> slots_;
+};
+
+#endif
@@ -106,7 +106,8 @@ CArgument NodeArgument::NapiObjectToCArgument(Napi::Env env, Napi::Object obj)
         "dim", "ws", "epoch", "minCount", "minCountLabel", "neg",
         "wordNgrams", "loss", "bucket", "minn", "maxn",
         "thread", "t", "label", "verbose", "pretrainedVectors",
-        "cutoff", "dsub", "qnorm", "qout", "retrain"};
+        "cutoff", "dsub", "qnorm", "qout", "retrain",
+        "seed", "inMemory", "shuffle", "deterministic"};
 
     for (uint32_t i = 0; i < indexLen; ++i)
     {
@@ -124,6 +125,11 @@ CArgument NodeArgument::NapiObjectToCArgument(Napi::Env env, Napi::Object obj)
       }
 
       Napi::Value value = obj.Get(keyValue);
+      if (value.IsBoolean() && !value.As<Napi::Boolean>().Value())
+      {
+        // Flags take no value, a disabled flag is simply left out
+        continue;
+      }
       NodeArgument::AddStringArgument(&arguments, &count, NodeArgument::concat("-", theKey));
 
       if (!value.IsBoolean())
@@ -0,0 +1,63 @@
+#include "predictBatchWorker.h"
+
+void PredictBatchWorker::Execute()
+{
+  try
+  {
+    wrapper_->loadModel();
+    result_ = wrapper_->predictBatch(sentences_, k_, nthreads_);
+  }
+  catch (std::string errorMessage)
+  {
+    SetError(errorMessage.c_str());
+  }
+  catch (const char *str)
+  {
+    SetError(str);
+  }
+  catch (const std::exception &e)
+  {
+    SetError(e.what());
+  }
+}
+
+void PredictBatchWorker::OnError(const Napi::Error &e)
+{
+  Napi::HandleScope scope(Env());
+  Napi::String error = Napi::String::New(Env(), e.Message());
+  deferred_.Reject(error);
+
+  // Call empty function
+  Callback().Call({error});
+}
+
+void PredictBatchWorker::OnOK()
+{
+  Napi::Env env = Env();
+  Napi::HandleScope scope(env);
+
+  Napi::Array labels = Napi::Array::New(env, result_.labels.size());
+  for (unsigned int i = 0; i < result_.labels.size(); i++)
+  {
+    labels.Set(i, Napi::String::New(env, result_.labels[i]));
+  }
+
+  Napi::Int32Array ids = Napi::Int32Array::New(env, result_.ids.size());
+  std::copy(result_.ids.begin(), result_.ids.end(), ids.Data());
+
+  Napi::Float32Array values = Napi::Float32Array::New(env, result_.values.size());
+  std::copy(result_.values.begin(), result_.values.end(), values.Data());
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set(Napi::String::New(env, "labels"), labels);
+  result.Set(Napi::String::New(env, "ids"), ids);
+  result.Set(Napi::String::New(env, "values"), values);
+
+  deferred_.Resolve(result);
+
+  // Call empty function
+  if (!Callback().IsEmpty())
+  {
+    Callback().Call({env.Null(), result});
+  }
+}
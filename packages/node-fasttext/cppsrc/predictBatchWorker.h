@@ -0,0 +1,42 @@
+
+#ifndef PREDICT_BATCH_WORKER_H
+#define PREDICT_BATCH_WORKER_H
+
+#include <napi.h>
+#include "wrapper.h"
+
+class PredictBatchWorker : public Napi::AsyncWorker
+{
+public:
+  PredictBatchWorker(
+      std::vector<std::string> sentences,
+      int32_t k,
+      int32_t nthreads,
+      Wrapper *wrapper,
+      Napi::Promise::Deferred deferred,
+      Napi::Function &callback)
+      : Napi::AsyncWorker(callback),
+        deferred_(deferred),
+        sentences_(sentences),
+        wrapper_(wrapper),
+        result_(),
+        k_(k),
+        nthreads_(nthreads){};
+
+  ~PredictBatchWorker(){};
+
+  Napi::Promise::Deferred deferred_;
+
+  void Execute();
+  void OnOK();
+  void OnError(const Napi::Error &e);
+
+private:
+  std::vector<std::string> sentences_;
+  Wrapper *wrapper_;
+  BatchPredictResult result_;
+  int32_t k_;
+  int32_t nthreads_;
+};
+
+#endif
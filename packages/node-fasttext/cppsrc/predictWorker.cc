@@ -5,7 +5,7 @@ void PredictWorker::Execute()
   try
   {
     wrapper_->loadModel();
-    result_ = wrapper_->predict(sentence_, k_);
+    result_ = hasIds_ ? wrapper_->predict(ids_, k_) : wrapper_->predict(sentence_, k_);
   }
   catch (std::string errorMessage)
   {
@@ -19,7 +19,22 @@ public:
         sentence_(sentence),
         wrapper_(wrapper),
         result_(),
-        k_(k){};
+        k_(k),
+        hasIds_(false){};
+
+  PredictWorker(
+      std::vector<int32_t> ids,
+      int32_t k,
+      Wrapper *wrapper,
+      Napi::Promise::Deferred deferred,
+      Napi::Function &callback)
+      : Napi::AsyncWorker(callback),
+        deferred_(deferred),
+        wrapper_(wrapper),
+        result_(),
+        k_(k),
+        hasIds_(true),
+        ids_(std::move(ids)){};
 
   ~PredictWorker(){};
 
@@ -34,6 +49,8 @@ private:
   Wrapper *wrapper_;
   std::vector<PredictResult> result_;
   int32_t k_;
+  bool hasIds_;
+  std::vector<int32_t> ids_;
 };
 
 #endif
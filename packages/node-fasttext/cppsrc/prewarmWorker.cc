@@ -0,0 +1,47 @@
+#include "prewarmWorker.h"
+
+void PrewarmWorker::Execute()
+{
+  try
+  {
+    wrapper_->loadModel();
+    result_ = wrapper_->prewarm(tokens_);
+  }
+  catch (std::string errorMessage)
+  {
+    SetError(errorMessage.c_str());
+  }
+  catch (const char *str)
+  {
+    SetError(str);
+  }
+  catch (const std::exception &e)
+  {
+    SetError(e.what());
+  }
+}
+
+void PrewarmWorker::OnError(const Napi::Error &e)
+{
+  Napi::HandleScope scope(Env());
+  Napi::String error = Napi::String::New(Env(), e.Message());
+  deferred_.Reject(error);
+
+  // Call empty function
+  Callback().Call({error});
+}
+
+void PrewarmWorker::OnOK()
+{
+  Napi::Env env = Env();
+  Napi::HandleScope scope(env);
+  Napi::Number result = Napi::Number::New(env, result_);
+
+  deferred_.Resolve(result);
+
+  // Call empty function
+  if (!Callback().IsEmpty())
+  {
+    Callback().Call({env.Null(), result});
+  }
+}
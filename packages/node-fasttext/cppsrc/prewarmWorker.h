@@ -0,0 +1,35 @@
+#ifndef PREWARM_WORKER_H
+#define PREWARM_WORKER_H
+
+#include <napi.h>
+#include "wrapper.h"
+
+class PrewarmWorker : public Napi::AsyncWorker
+{
+public:
+  PrewarmWorker(
+      std::vector<std::string> tokens,
+      Wrapper *wrapper,
+      Napi::Promise::Deferred deferred,
+      Napi::Function &callback)
+      : Napi::AsyncWorker(callback),
+        deferred_(deferred),
+        tokens_(std::move(tokens)),
+        wrapper_(wrapper),
+        result_(0){};
+
+  ~PrewarmWorker(){};
+
+  Napi::Promise::Deferred deferred_;
+
+  void Execute();
+  void OnOK();
+  void OnError(const Napi::Error &e);
+
+private:
+  std::vector<std::string> tokens_;
+  Wrapper *wrapper_;
+  size_t result_;
+};
+
+#endif
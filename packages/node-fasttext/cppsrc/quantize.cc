@@ -1,11 +1,26 @@
 #include "node-argument.h"
 #include "quantize.h"
+#include "binding-utils.h"
 
-void QuantizeWorker::Execute()
+void QuantizeWorker::Execute(const ExecutionProgress &progress)
 {
+  FastText::TrainCallback callback;
+  if (!progressCallback_.IsEmpty())
+  {
+    callback = [this, &progress](float value, float loss, double wst, double lr, int64_t eta) {
+      int percent = value * 100;
+      int last = lastPercent_;
+      if (percent > last && lastPercent_.compare_exchange_strong(last, percent))
+      {
+        TrainProgress data = {value, loss, wst, lr, eta};
+        progress.Send(&data, 1);
+      }
+    };
+  }
+
   try
   {
-    result_ = wrapper_->quantize(args_);
+    result_ = wrapper_->quantize(args_, callback, aborted_);
   }
   catch (const std::string errorMessage)
   {
@@ -21,6 +36,17 @@ void QuantizeWorker::Execute()
   }
 }
 
+void QuantizeWorker::OnProgress(const TrainProgress *data, size_t count)
+{
+  Napi::Env env = Env();
+  Napi::HandleScope scope(env);
+
+  for (size_t i = 0; i < count; i++)
+  {
+    progressCallback_.Call({napi_utils::progressToNapi(env, data[i])});
+  }
+}
+
 void QuantizeWorker::OnError(const Napi::Error &e)
 {
   Napi::HandleScope scope(Env());
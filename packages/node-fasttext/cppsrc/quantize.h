@@ -4,7 +4,7 @@
 #include <napi.h>
 #include "wrapper.h"
 
-class QuantizeWorker : public Napi::AsyncWorker
+class QuantizeWorker : public Napi::AsyncProgressQueueWorker<TrainProgress>
 {
 public:
   QuantizeWorker(
@@ -12,24 +12,40 @@ public:
       Wrapper *wrapper,
       Napi::Promise::Deferred deferred,
       Napi::Function &callback)
-      : Napi::AsyncWorker(callback),
+      : Napi::AsyncProgressQueueWorker<TrainProgress>(callback),
         deferred_(deferred),
         args_(args),
         wrapper_(wrapper),
-        result_(){};
+        aborted_(wrapper->newJob()),
+        result_(),
+        lastPercent_(-1){};
 
   ~QuantizeWorker(){};
 
+  /**
+   * Receives the retraining progress (only with `retrain`) at every percent.
+   */
+  void SetProgressCallback(Napi::Function &progressCallback)
+  {
+    progressCallback_ = Napi::Persistent(progressCallback);
+  }
+
   Napi::Promise::Deferred deferred_;
 
-  void Execute();
+  void Execute(const ExecutionProgress &progress);
+  void OnProgress(const TrainProgress *data, size_t count);
   void OnOK();
   void OnError(const Napi::Error &e);
 
 private:
   const std::vector<std::string> args_;
   Wrapper *wrapper_;
+  // Set by the classifier's cancel() from the moment the job is queued.
+  AbortFlag aborted_;
   std::map<std::string, std::string> result_;
+
+  Napi::FunctionReference progressCallback_;
+  std::atomic<int> lastPercent_;
 };
 
 #endif
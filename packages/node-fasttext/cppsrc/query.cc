@@ -7,7 +7,10 @@ Napi::Object FasttextQuery::Init(Napi::Env env, Napi::Object exports)
   Napi::HandleScope scope(env);
   Napi::Function func = DefineClass(env, "FasttextQuery",
                                     {InstanceMethod("nn", &FasttextQuery::Nn),
-                                     InstanceMethod("getWordVector", &FasttextQuery::getWordVector)});
+                                     InstanceMethod("getWordVector", &FasttextQuery::getWordVector),
+                                     InstanceMethod("prewarm", &FasttextQuery::Prewarm),
+                                     InstanceMethod("getSentenceVectors", &FasttextQuery::GetSentenceVectors),
+                                     InstanceMethod("load", &FasttextQuery::Load)});
 
   constructor = Napi::Persistent(func);
   constructor.SuppressDestruct();
@@ -26,8 +29,48 @@ FasttextQuery::FasttextQuery(const Napi::CallbackInfo &info) : Napi::ObjectWrap<
     Napi::TypeError::New(env, "Path to model file is missing!").ThrowAsJavaScriptException();
   }
 
-  std::string modelFileName = info[0].As<Napi::String>().Utf8Value();
-  this->wrapper_ = new Wrapper(modelFileName);
+  storage_type inputStorage = storage_type::fp32;
+  int64_t subwordCacheSize = -1;
+  int32_t loadThreads = -1;
+  if (info.Length() > 1 && info[1].IsObject())
+  {
+    Napi::Object options = info[1].As<Napi::Object>();
+    if (options.Has("subwordCacheSize") && options.Get("subwordCacheSize").IsNumber())
+    {
+      subwordCacheSize = options.Get("subwordCacheSize").As<Napi::Number>().Int64Value();
+    }
+    if (options.Has("loadThreads") && options.Get("loadThreads").IsNumber())
+    {
+      loadThreads = options.Get("loadThreads").As<Napi::Number>().Int32Value();
+    }
+    if (options.Has("storage") && !options.Get("storage").IsUndefined())
+    {
+      std::string storage = options.Get("storage").ToString().Utf8Value();
+      if (storage == "fp16")
+      {
+        inputStorage = storage_type::fp16;
+      }
+      else if (storage == "bf16")
+      {
+        inputStorage = storage_type::bf16;
+      }
+      else if (storage != "fp32")
+      {
+        Napi::TypeError::New(env, "storage must be one of 'fp32', 'fp16' or 'bf16'").ThrowAsJavaScriptException();
+      }
+    }
+  }
+
+  this->modelFilename_ = info[0].As<Napi::String>().Utf8Value();
+  this->wrapper_ = new Wrapper(this->modelFilename_, inputStorage);
+  if (subwordCacheSize >= 0)
+  {
+    this->wrapper_->setSubwordCacheSize(subwordCacheSize);
+  }
+  if (loadThreads > 0)
+  {
+    this->wrapper_->setLoadThreads(loadThreads);
+  }
 }
 
 Napi::Value FasttextQuery::Nn(const Napi::CallbackInfo &info)
@@ -92,4 +135,119 @@ Napi::Value FasttextQuery::getWordVector(const Napi::CallbackInfo &info)
   worker->Queue();
 
   return worker->deferred_.Promise();
-}
\ No newline at end of file
+}
+Napi::Value FasttextQuery::Prewarm(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  Napi::HandleScope scope(env);
+
+  std::vector<std::string> tokens;
+  if (info.Length() == 0 || !napi_utils::stringsFromNapi(info[0], tokens))
+  {
+    Napi::TypeError::New(env, "tokens must be an array of strings").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Function callback = Napi::Function::New(env, EmptyCallback);
+  if (info.Length() > 1 && info[1].IsFunction())
+  {
+    callback = info[1].As<Napi::Function>();
+  }
+
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(info.Env());
+
+  PrewarmWorker *worker = new PrewarmWorker(tokens, this->wrapper_, deferred, callback);
+  worker->Queue();
+
+  return worker->deferred_.Promise();
+}
+
+Napi::Value FasttextQuery::Load(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  Napi::HandleScope scope(env);
+
+  Napi::Function callback = Napi::Function::New(env, EmptyCallback);
+  if (info.Length() > 0 && info[0].IsFunction())
+  {
+    callback = info[0].As<Napi::Function>();
+  }
+
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(info.Env());
+
+  LoadModelWorker *worker = new LoadModelWorker(this->modelFilename_, this->wrapper_, deferred, callback);
+  worker->Queue();
+
+  return worker->deferred_.Promise();
+}
+
+Napi::Value FasttextQuery::GetSentenceVectors(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  Napi::HandleScope scope(env);
+  Napi::Function callback = Napi::Function::New(env, EmptyCallback);
+  int32_t nthreads = 1;
+
+  if (info.Length() == 0 || !info[0].IsArray())
+  {
+    Napi::TypeError::New(env, "utterances must be an array of token arrays").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Array napiUtterances = info[0].As<Napi::Array>();
+  std::vector<std::vector<std::string>> utterances(napiUtterances.Length());
+  for (uint32_t i = 0; i < napiUtterances.Length(); i++)
+  {
+    if (!napi_utils::stringsFromNapi(napiUtterances.Get(i), utterances[i]))
+    {
+      Napi::TypeError::New(env, "utterances must be an array of token arrays").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+  }
+
+  bool hasWeights = info.Length() > 1 && info[1].IsArray();
+  std::vector<std::vector<float>> weights;
+  if (hasWeights)
+  {
+    Napi::Array napiWeights = info[1].As<Napi::Array>();
+    bool valid = napiWeights.Length() == utterances.size();
+    weights.resize(utterances.size());
+    for (uint32_t i = 0; valid && i < napiWeights.Length(); i++)
+    {
+      Napi::Value row = napiWeights.Get(i);
+      valid = row.IsArray() && row.As<Napi::Array>().Length() == utterances[i].size();
+      for (uint32_t j = 0; valid && j < utterances[i].size(); j++)
+      {
+        Napi::Value weight = row.As<Napi::Array>().Get(j);
+        valid = weight.IsNumber();
+        if (valid)
+        {
+          weights[i].push_back(weight.As<Napi::Number>().FloatValue());
+        }
+      }
+    }
+    if (!valid)
+    {
+      Napi::TypeError::New(env, "weights must have one number per token").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+  }
+
+  if (info.Length() > 2 && info[2].IsNumber())
+  {
+    nthreads = info[2].As<Napi::Number>().Int32Value();
+  }
+
+  if (info.Length() > 3 && info[3].IsFunction())
+  {
+    callback = info[3].As<Napi::Function>();
+  }
+
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(info.Env());
+
+  SentenceVectorsWorker *worker = new SentenceVectorsWorker(
+      std::move(utterances), std::move(weights), hasWeights, nthreads, this->wrapper_, deferred, callback);
+  worker->Queue();
+
+  return worker->deferred_.Promise();
+}
@@ -5,6 +5,9 @@
 #include "wrapper.h"
 #include "nnWorker.h"
 #include "vecWorker.h"
+#include "prewarmWorker.h"
+#include "sentenceVectorsWorker.h"
+#include "loadModel.h"
 #include "node-util.h"
 #include "binding-utils.h"
 
@@ -26,7 +29,11 @@ private:
   static Napi::FunctionReference constructor;
   Napi::Value Nn(const Napi::CallbackInfo &info);
   Napi::Value getWordVector(const Napi::CallbackInfo &info);
+  Napi::Value Prewarm(const Napi::CallbackInfo &info);
+  Napi::Value GetSentenceVectors(const Napi::CallbackInfo &info);
+  Napi::Value Load(const Napi::CallbackInfo &info);
 
+  std::string modelFilename_;
   Wrapper *wrapper_;
 };
 
@@ -0,0 +1,50 @@
+#include "sentenceVectorsWorker.h"
+
+#include <algorithm>
+
+void SentenceVectorsWorker::Execute()
+{
+  try
+  {
+    wrapper_->loadModel();
+    result_ = wrapper_->getSentenceVectors(utterances_, hasWeights_ ? &weights_ : nullptr, nthreads_);
+  }
+  catch (std::string errorMessage)
+  {
+    SetError(errorMessage.c_str());
+  }
+  catch (const char *str)
+  {
+    SetError(str);
+  }
+  catch (const std::exception &e)
+  {
+    SetError(e.what());
+  }
+}
+
+void SentenceVectorsWorker::OnError(const Napi::Error &e)
+{
+  Napi::HandleScope scope(Env());
+  Napi::String error = Napi::String::New(Env(), e.Message());
+  deferred_.Reject(error);
+
+  // Call empty function
+  Callback().Call({error});
+}
+
+void SentenceVectorsWorker::OnOK()
+{
+  Napi::Env env = Env();
+  Napi::HandleScope scope(env);
+  Napi::Float32Array result = Napi::Float32Array::New(env, result_.size());
+  std::copy(result_.begin(), result_.end(), result.Data());
+
+  deferred_.Resolve(result);
+
+  // Call empty function
+  if (!Callback().IsEmpty())
+  {
+    Callback().Call({env.Null(), result});
+  }
+}
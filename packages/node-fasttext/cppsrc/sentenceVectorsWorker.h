@@ -0,0 +1,44 @@
+#ifndef SENTENCE_VECTORS_WORKER_H
+#define SENTENCE_VECTORS_WORKER_H
+
+#include <napi.h>
+#include "wrapper.h"
+
+class SentenceVectorsWorker : public Napi::AsyncWorker
+{
+public:
+  SentenceVectorsWorker(
+      std::vector<std::vector<std::string>> utterances,
+      std::vector<std::vector<float>> weights,
+      bool hasWeights,
+      int32_t nthreads,
+      Wrapper *wrapper,
+      Napi::Promise::Deferred deferred,
+      Napi::Function &callback)
+      : Napi::AsyncWorker(callback),
+        deferred_(deferred),
+        utterances_(std::move(utterances)),
+        weights_(std::move(weights)),
+        hasWeights_(hasWeights),
+        nthreads_(nthreads),
+        wrapper_(wrapper),
+        result_(){};
+
+  ~SentenceVectorsWorker(){};
+
+  Napi::Promise::Deferred deferred_;
+
+  void Execute();
+  void OnOK();
+  void OnError(const Napi::Error &e);
+
+private:
+  std::vector<std::vector<std::string>> utterances_;
+  std::vector<std::vector<float>> weights_;
+  bool hasWeights_;
+  int32_t nthreads_;
+  Wrapper *wrapper_;
+  std::vector<float> result_;
+};
+
+#endif
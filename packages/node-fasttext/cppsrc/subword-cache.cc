@@ -0,0 +1,75 @@
+#include "subword-cache.h"
+
+#include <functional>
+
+SubwordCache::SubwordCache(size_t capacity)
+    : capacity_(capacity),
+      shardCapacity_((capacity + SHARDS - 1) / SHARDS) {}
+
+SubwordCache::Shard &SubwordCache::shardOf(const std::string &token)
+{
+  return shards_[std::hash<std::string>()(token) % SHARDS];
+}
+
+bool SubwordCache::get(const std::string &token, std::vector<int32_t> &ids)
+{
+  if (capacity_ == 0)
+  {
+    return false;
+  }
+  Shard &shard = shardOf(token);
+  std::lock_guard<std::mutex> lock(shard.mtx);
+  auto it = shard.index.find(token);
+  if (it == shard.index.end())
+  {
+    return false;
+  }
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+  ids = it->second->second;
+  return true;
+}
+
+void SubwordCache::put(const std::string &token, const std::vector<int32_t> &ids)
+{
+  if (capacity_ == 0)
+  {
+    return;
+  }
+  Shard &shard = shardOf(token);
+  std::lock_guard<std::mutex> lock(shard.mtx);
+  auto it = shard.index.find(token);
+  if (it != shard.index.end())
+  {
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    it->second->second = ids;
+    return;
+  }
+  if (shard.lru.size() >= shardCapacity_)
+  {
+    shard.index.erase(shard.lru.back().first);
+    shard.lru.pop_back();
+  }
+  shard.lru.emplace_front(token, ids);
+  shard.index[token] = shard.lru.begin();
+}
+
+void SubwordCache::clear()
+{
+  for (size_t i = 0; i < SHARDS; i++)
+  {
+    std::lock_guard<std::mutex> lock(shards_[i].mtx);
+    shards_[i].index.clear();
+    shards_[i].lru.clear();
+  }
+}
+
+size_t SubwordCache::size()
+{
+  size_t n = 0;
+  for (size_t i = 0; i < SHARDS; i++)
+  {
+    std::lock_guard<std::mutex> lock(shards_[i].mtx);
+    n += shards_[i].lru.size();
+  }
+  return n;
+}
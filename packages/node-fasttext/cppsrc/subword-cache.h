@@ -0,0 +1,54 @@
+#ifndef SUBWORD_CACHE_H
+#define SUBWORD_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Bounded memo of the subword ids of out-of-vocabulary tokens.
+ *
+ * Hashing the character ngrams of a token is most of the cost of its vector,
+ * and user input repeats the same misspellings and codes over and over.
+ * Tokens are spread over independently locked shards, each one evicting its
+ * least recently used entry, so concurrent workers rarely contend.
+ */
+class SubwordCache
+{
+public:
+  explicit SubwordCache(size_t capacity);
+
+  bool get(const std::string &token, std::vector<int32_t> &ids);
+  void put(const std::string &token, const std::vector<int32_t> &ids);
+  void clear();
+  size_t size();
+
+  size_t capacity() const { return capacity_; }
+
+private:
+  static const size_t SHARDS = 16;
+
+  typedef std::list<std::pair<std::string, std::vector<int32_t>>> Entries;
+
+  struct Shard
+  {
+    std::mutex mtx;
+    Entries lru;
+    std::unordered_map<std::string, Entries::iterator> index;
+  };
+
+  SubwordCache(const SubwordCache &) = delete;
+  SubwordCache &operator=(const SubwordCache &) = delete;
+
+  Shard &shardOf(const std::string &token);
+
+  size_t capacity_;
+  size_t shardCapacity_;
+  Shard shards_[SHARDS];
+};
+
+#endif
@@ -1,11 +1,33 @@
 #include "train.h"
 #include "node-argument.h"
+#include "binding-utils.h"
 
-void TrainWorker::Execute()
+void TrainWorker::Execute(const ExecutionProgress &progress)
 {
+  FastText::TrainCallback callback;
+  if (!progressCallback_.IsEmpty())
+  {
+    // Called by every training thread; only the first call of each percent is forwarded.
+    callback = [this, &progress](float value, float loss, double wst, double lr, int64_t eta) {
+      int percent = value * 100;
+      int last = lastPercent_;
+      if (percent > last && lastPercent_.compare_exchange_strong(last, percent))
+      {
+        TrainProgress data = {value, loss, wst, lr, eta};
+        progress.Send(&data, 1);
+      }
+    };
+  }
+
   try
   {
-    result_ = wrapper_->train(args_);
+    result_ = wrapper_->train(args_,
+                              hasCorpus_ ? &corpus_ : nullptr,
+                              toBuffer_ ? &model_ : nullptr,
+                              callback,
+                              aborted_);
+    corpus_.clear();
+    corpus_.shrink_to_fit();
   }
   catch (std::string errorMessage)
   {
@@ -21,6 +43,17 @@ void TrainWorker::Execute()
   }
 }
 
+void TrainWorker::OnProgress(const TrainProgress *data, size_t count)
+{
+  Napi::Env env = Env();
+  Napi::HandleScope scope(env);
+
+  for (size_t i = 0; i < count; i++)
+  {
+    progressCallback_.Call({napi_utils::progressToNapi(env, data[i])});
+  }
+}
+
 void TrainWorker::OnError(const Napi::Error &e)
 {
   Napi::HandleScope scope(Env());
@@ -38,6 +71,10 @@ void TrainWorker::OnOK()
 
   NodeArgument::NodeArgument nodeArg;
   Napi::Object result = nodeArg.mapToNapiObject(env, result_);
+  if (toBuffer_)
+  {
+    result.Set(Napi::String::New(env, "model"), Napi::Buffer<char>::Copy(env, model_.data(), model_.size()));
+  }
   deferred_.Resolve(result);
 
   // Call empty function
@@ -4,28 +4,68 @@
 #include <napi.h>
 #include "wrapper.h"
 
-class TrainWorker : public Napi::AsyncWorker
+class TrainWorker : public Napi::AsyncProgressQueueWorker<TrainProgress>
 {
 public:
   TrainWorker(const std::vector<std::string> args, Wrapper *wrapper, Napi::Promise::Deferred deferred, Napi::Function &callback)
-      : Napi::AsyncWorker(callback),
+      : Napi::AsyncProgressQueueWorker<TrainProgress>(callback),
         args_(args),
         wrapper_(wrapper),
+        aborted_(wrapper->newJob()),
         deferred_(deferred),
-        result_(){};
+        result_(),
+        hasCorpus_(false),
+        toBuffer_(false),
+        lastPercent_(-1){};
 
   ~TrainWorker(){};
 
+  /**
+   * Trains from an in-memory corpus (one example per line) instead of args' input file.
+   */
+  void SetCorpus(std::string corpus)
+  {
+    corpus_ = std::move(corpus);
+    hasCorpus_ = true;
+  }
+
+  /**
+   * Resolves with the serialized model in `model` instead of writing .bin/.vec files.
+   */
+  void SetOutputToBuffer()
+  {
+    toBuffer_ = true;
+  }
+
+  /**
+   * Receives progress, loss, words/sec/thread, learning rate and eta at every percent of training.
+   */
+  void SetProgressCallback(Napi::Function &progressCallback)
+  {
+    progressCallback_ = Napi::Persistent(progressCallback);
+  }
+
   Napi::Promise::Deferred deferred_;
 
-  void Execute();
+  void Execute(const ExecutionProgress &progress);
+  void OnProgress(const TrainProgress *data, size_t count);
   void OnOK();
   void OnError(const Napi::Error &e);
 
 private:
   const std::vector<std::string> args_;
   Wrapper *wrapper_;
+  // Set by the classifier's cancel() from the moment the job is queued.
+  AbortFlag aborted_;
   std::map<std::string, std::string> result_;
+
+  bool hasCorpus_;
+  std::string corpus_;
+  bool toBuffer_;
+  std::string model_;
+
+  Napi::FunctionReference progressCallback_;
+  std::atomic<int> lastPercent_;
 };
 
 #endif
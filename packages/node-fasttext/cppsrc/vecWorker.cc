@@ -15,7 +15,6 @@ void VecWorker::Execute()
   try
   {
     wrapper_->loadModel();
-    wrapper_->precomputeWordVectors();
     result_ = this->wrapper_->getWordVector(query_);
   }
   catch (std::string errorMessage)
@@ -4,6 +4,7 @@
 
 #include <math.h>
 
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -12,16 +13,50 @@
 #include <vector>
 #include <queue>
 #include <algorithm>
+#include <chrono>
 
 using fasttext::entry_type;
 using fasttext::model_name;
 
 constexpr int32_t FASTTEXT_VERSION = 12; /* Version 1b */
 constexpr int32_t FASTTEXT_FILEFORMAT_MAGIC_INT32 = 793712314;
+constexpr size_t SUBWORD_CACHE_SIZE = 100000;
+constexpr int32_t LOAD_THREADS = 4;
+constexpr int32_t MAX_BATCH_THREADS = 64;
 
-Wrapper::Wrapper(std::string modelFilename)
-    : quant_(false),
+static std::string storageVariant(storage_type storage)
+{
+  switch (storage)
+  {
+  case storage_type::fp16:
+    return "fp16";
+  case storage_type::bf16:
+    return "bf16";
+  default:
+    return "";
+  }
+}
+
+// Threads used for a batch of n inputs: never more than there are inputs,
+// nor more than the machine (or MAX_BATCH_THREADS when it cannot tell) runs.
+static int32_t batchThreads(int32_t nthreads, int64_t n)
+{
+  int64_t ceiling = std::thread::hardware_concurrency();
+  if (ceiling == 0)
+  {
+    ceiling = MAX_BATCH_THREADS;
+  }
+  return std::max<int64_t>(1, std::min<int64_t>({(int64_t)nthreads, n, ceiling}));
+}
+
+Wrapper::Wrapper(std::string modelFilename, storage_type inputStorage)
+    : subwordCache_(new SubwordCache(SUBWORD_CACHE_SIZE)),
+      quant_(false),
       modelFilename_(modelFilename),
+      inputStorage_(inputStorage),
+      loadThreads_(LOAD_THREADS),
+      loadBytes_(0),
+      loadSeconds_(0),
       isLoaded_(false),
       isPrecomputed_(false) {}
 
@@ -40,7 +75,54 @@ bool Wrapper::fileExist(const std::string &filename)
 
 void Wrapper::getVector(Vector &vec, const std::string &word)
 {
-  fastText_.getWordVector(vec, word);
+  int32_t id = dict_->getId(word);
+  if (id >= 0)
+  {
+    fastText_->getWordVector(vec, dict_->getSubwords(id));
+    return;
+  }
+  if (args_->maxn <= 0)
+  {
+    fastText_->getWordVector(vec, word);
+    return;
+  }
+  std::vector<int32_t> subwords;
+  if (!subwordCache_->get(word, subwords))
+  {
+    subwords = dict_->getSubwords(word);
+    subwordCache_->put(word, subwords);
+  }
+  fastText_->getWordVector(vec, subwords);
+}
+
+void Wrapper::setSubwordCacheSize(size_t capacity)
+{
+  subwordCache_.reset(new SubwordCache(capacity));
+}
+
+void Wrapper::setLoadThreads(int32_t nthreads)
+{
+  loadThreads_ = std::max(1, nthreads);
+}
+
+size_t Wrapper::prewarm(const std::vector<std::string> &tokens)
+{
+  size_t added = 0;
+  if (args_->maxn <= 0)
+  {
+    return added;
+  }
+  std::vector<int32_t> subwords;
+  for (const std::string &token : tokens)
+  {
+    if (dict_->getId(token) >= 0 || subwordCache_->get(token, subwords))
+    {
+      continue;
+    }
+    subwordCache_->put(token, dict_->getSubwords(token));
+    added++;
+  }
+  return added;
 }
 
 bool Wrapper::checkModel(std::istream &in)
@@ -79,12 +161,54 @@ std::map<std::string, std::string> Wrapper::loadModel(std::string filename)
   {
     return getModelInfo();
   }
-  mtx_.lock();
-  if (isLoaded_)
+  std::lock_guard<std::mutex> lock(mtx_);
+  if (!isLoaded_)
   {
-    mtx_.unlock();
-    return getModelInfo();
+    acquireModel(filename);
   }
+  return getModelInfo();
+}
+
+std::map<std::string, std::string> Wrapper::reloadModel(const std::string &filename)
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+  // The new file has its own registry key, the previous model is released
+  // once no other instance uses it.
+  isLoaded_ = false;
+  fastText_.reset();
+  acquireModel(filename);
+  return getModelInfo();
+}
+
+void Wrapper::acquireModel(const std::string &filename)
+{
+  auto start = std::chrono::steady_clock::now();
+  loadBytes_ = 0;
+  fastText_ = ModelRegistry::getInstance().acquire(
+      filename,
+      [this](FastTextNapi &fastText, const std::string &filename) { loadModel(fastText, filename); },
+      storageVariant(inputStorage_));
+  loadSeconds_ = utils::getDuration(start, std::chrono::steady_clock::now());
+
+  setModel(fastText_->getModelInfo());
+  isLoaded_ = true;
+}
+
+void Wrapper::setModel(const ModelInfo &modelInfo)
+{
+  args_ = modelInfo.args;
+  dict_ = modelInfo.dict;
+  model_ = modelInfo.model;
+  quantInput_ = std::dynamic_pointer_cast<const QuantMatrix>(modelInfo.input);
+  inputRows_ = modelInfo.input->size(0);
+  wordVectors_.reset();
+  wordNorms_.clear();
+  isPrecomputed_ = false;
+  subwordCache_->clear();
+}
+
+void Wrapper::loadModel(FastTextNapi &fastText, const std::string &filename)
+{
   std::ifstream ifs(filename, std::ifstream::binary);
   if (!ifs.is_open())
   {
@@ -94,23 +218,9 @@ std::map<std::string, std::string> Wrapper::loadModel(std::string filename)
   {
     throw "Model file has wrong file format!";
   }
-  std::map<std::string, std::string> info = loadModel(ifs);
+  fastText.loadAndGetModel(ifs, inputStorage_, filename, loadThreads_);
+  loadBytes_ = ifs.tellg();
   ifs.close();
-  isLoaded_ = true;
-  mtx_.unlock();
-
-  return info;
-}
-
-std::map<std::string, std::string> Wrapper::loadModel(std::istream &in)
-{
-  auto modelInfo = fastText_.loadAndGetModel(in);
-
-  args_ = modelInfo.args;
-  dict_ = modelInfo.dict;
-  model_ = modelInfo.model;
-
-  return getModelInfo();
 }
 
 std::map<std::string, std::string> Wrapper::getModelInfo()
@@ -178,6 +288,11 @@ std::map<std::string, std::string> Wrapper::getModelInfo()
   response["qout"] = std::to_string(args_->qout);
   response["retrain"] = std::to_string(args_->retrain);
 
+  // last load
+  response["load_bytes"] = std::to_string(loadBytes_);
+  response["load_ms"] = std::to_string(loadSeconds_ * 1000);
+  response["load_threads"] = std::to_string(loadThreads_);
+
   return response;
 }
 
@@ -193,16 +308,30 @@ void Wrapper::precomputeWordVectors()
     precomputeMtx_.unlock();
     return;
   }
-  DenseMatrix wordVectors(dict_->nwords(), args_->dim);
-  // wordVectors_ = Matrix(dict_->nwords(), args_->dim);
   Vector vec(args_->dim);
-  // wordVectors_.zero();
-  for (int32_t i = 0; i < dict_->nwords(); i++)
+  if (quantInput_)
+  {
+    // Quantized models stay compressed: only the norms are kept.
+    wordNorms_.assign(dict_->nwords(), 0.0);
+    for (int32_t i = 0; i < dict_->nwords(); i++)
+    {
+      getVector(vec, dict_->getWord(i));
+      wordNorms_[i] = vec.norm();
+    }
+  }
+  else
   {
-    std::string word = dict_->getWord(i);
-    getVector(vec, word);
-    real norm = vec.norm();
-    // wordVectors_.addRow(vec, i, 1.0 / norm);
+    wordVectors_.reset(new DenseMatrix(dict_->nwords(), args_->dim));
+    wordVectors_->zero();
+    for (int32_t i = 0; i < dict_->nwords(); i++)
+    {
+      getVector(vec, dict_->getWord(i));
+      real norm = vec.norm();
+      if (norm > 0)
+      {
+        wordVectors_->addVectorToRow(vec, i, 1.0 / norm);
+      }
+    }
   }
   isPrecomputed_ = true;
   precomputeMtx_.unlock();
@@ -217,28 +346,50 @@ std::vector<PredictResult> Wrapper::findNN(const Vector &queryVec, int32_t k,
   {
     queryNorm = 1;
   }
-  std::priority_queue<std::pair<real, std::string>> heap;
-  Vector vec(args_->dim);
-  for (int32_t i = 0; i < dict_->nwords(); i++)
+
+  std::vector<std::pair<real, int32_t>> scores(dict_->nwords());
+  if (quantInput_)
   {
-    std::string word = dict_->getWord(i);
-    real dp = wordVectors_.dotRow(queryVec, i);
-    heap.push(std::make_pair(dp / queryNorm, word));
+    // A word vector is the mean of its subword rows, so its dot product is the
+    // mean of the row scores, each one being a sum of table lookups.
+    std::vector<real> table;
+    quantInput_->computeDotTable(queryVec, table);
+    for (int32_t i = 0; i < dict_->nwords(); i++)
+    {
+      const std::vector<int32_t> &ngrams = dict_->getSubwords(i);
+      real dp = 0.0;
+      for (int32_t row : ngrams)
+      {
+        dp += quantInput_->dotRow(table, row);
+      }
+      if (!ngrams.empty() && wordNorms_[i] > 0)
+      {
+        dp /= ngrams.size() * wordNorms_[i];
+      }
+      scores[i] = std::make_pair(dp / queryNorm, i);
+    }
+  }
+  else
+  {
+    for (int32_t i = 0; i < dict_->nwords(); i++)
+    {
+      scores[i] = std::make_pair(wordVectors_->dotRow(queryVec, i) / queryNorm, i);
+    }
   }
 
-  PredictResult response;
+  // Banned words are at most banSet.size() of the best ones.
+  size_t n = std::min(scores.size(), (size_t)k + banSet.size());
+  std::partial_sort(scores.begin(), scores.begin() + n, scores.end(),
+                    [](const std::pair<real, int32_t> &a, const std::pair<real, int32_t> &b) { return a.first > b.first; });
+
   std::vector<PredictResult> arr;
-  int32_t i = 0;
-  while (i < k && heap.size() > 0)
+  for (size_t i = 0; i < n && (int32_t)arr.size() < k; i++)
   {
-    auto it = banSet.find(heap.top().second);
-    if (it == banSet.end())
+    const std::string &word = dict_->getWord(scores[i].second);
+    if (banSet.find(word) == banSet.end())
     {
-      response = {heap.top().second, exp(heap.top().first)};
-      arr.push_back(response);
-      i++;
+      arr.push_back({word, scores[i].first});
     }
-    heap.pop();
   }
   return arr;
 }
@@ -253,6 +404,62 @@ std::vector<PredictResult> Wrapper::nn(std::string query, int32_t k)
   return findNN(queryVec, k, banSet);
 }
 
+std::vector<float> Wrapper::getSentenceVectors(const std::vector<std::vector<std::string>> &utterances,
+                                               const std::vector<std::vector<float>> *weights,
+                                               int32_t nthreads)
+{
+  const int64_t n = utterances.size();
+  const int32_t dim = args_->dim;
+  std::vector<float> result(n * dim, 0);
+
+  auto embedRange = [&](int64_t begin, int64_t end) {
+    Vector vec(dim);
+    Vector sum(dim);
+
+    for (int64_t i = begin; i < end; i++)
+    {
+      const std::vector<std::string> &tokens = utterances[i];
+      sum.zero();
+      real totalWeight = 0;
+      for (size_t j = 0; j < tokens.size(); j++)
+      {
+        getVector(vec, tokens[j]);
+        real norm = vec.norm();
+        if (norm <= 0)
+        {
+          continue;
+        }
+        real weight = weights ? (*weights)[i][j] : 1.0;
+        totalWeight += weight;
+        sum.addVector(vec, weight / norm);
+      }
+      if (totalWeight != 0)
+      {
+        sum.mul(1.0 / totalWeight);
+        std::copy(sum.data(), sum.data() + dim, result.begin() + i * dim);
+      }
+    }
+  };
+
+  nthreads = batchThreads(nthreads, n);
+  if (nthreads == 1)
+  {
+    embedRange(0, n);
+    return result;
+  }
+
+  std::vector<std::thread> threads;
+  for (int32_t t = 0; t < nthreads; t++)
+  {
+    threads.push_back(std::thread(embedRange, t * n / nthreads, (t + 1) * n / nthreads));
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+  return result;
+}
+
 std::vector<double> Wrapper::getWordVector(std::string query)
 {
   Vector queryVec(args_->dim);
@@ -272,8 +479,6 @@ std::vector<double> Wrapper::getWordVector(std::string query)
 
 std::vector<PredictResult> Wrapper::predict(std::string sentence, int32_t k)
 {
-
-  std::vector<PredictResult> arr;
   std::vector<int32_t> words, labels;
   std::istringstream in(sentence);
 
@@ -281,15 +486,38 @@ std::vector<PredictResult> Wrapper::predict(std::string sentence, int32_t k)
 
   // std::cerr << "Got line!" << std::endl;
 
+  return predictWords(words, k);
+}
+
+std::vector<int32_t> Wrapper::getIds(const std::vector<std::string> &tokens)
+{
+  std::vector<int32_t> words, labels;
+  dict_->getLine(tokens, words, labels);
+  return words;
+}
+
+std::vector<PredictResult> Wrapper::predict(const std::vector<int32_t> &ids, int32_t k)
+{
+  for (int32_t id : ids)
+  {
+    if (id < 0 || id >= inputRows_)
+    {
+      throw "Input id " + std::to_string(id) + " is out of range";
+    }
+  }
+  return predictWords(ids, k);
+}
+
+std::vector<PredictResult> Wrapper::predictWords(const std::vector<int32_t> &words, int32_t k)
+{
+  std::vector<PredictResult> arr;
   if (words.empty())
   {
     return arr;
   }
 
-  Vector hidden(args_->dim);
-  Vector output(dict_->nlabels());
   std::vector<std::pair<real, int32_t>> modelPredictions;
-  fastText_.predict(k, words, modelPredictions, 0.0001);
+  fastText_->predict(k, words, modelPredictions, 0.0001);
 
   PredictResult response;
 
@@ -302,33 +530,229 @@ std::vector<PredictResult> Wrapper::predict(std::string sentence, int32_t k)
   return arr;
 }
 
-std::map<std::string, std::string> Wrapper::train(const std::vector<std::string> args)
+BatchPredictResult Wrapper::predictBatch(const std::vector<std::string> &sentences, int32_t k, int32_t nthreads)
+{
+  if (k <= 0)
+  {
+    throw "k needs to be 1 or higher!";
+  }
+  if (args_->model != fasttext::model_name::sup)
+  {
+    throw "Model needs to be supervised for prediction!";
+  }
+
+  BatchPredictResult result;
+  const int64_t n = sentences.size();
+  result.ids.assign(n * k, -1);
+  result.values.assign(n * k, 0);
+  for (int32_t i = 0; i < dict_->nlabels(); i++)
+  {
+    result.labels.push_back(dict_->getLabel(i));
+  }
+
+  // Each thread scores a contiguous slice and reuses its buffers across sentences.
+  auto predictRange = [&](int64_t begin, int64_t end) {
+    Model::State state(args_->dim, dict_->nlabels(), 0);
+    std::vector<int32_t> words, labels;
+    std::vector<std::pair<real, int32_t>> modelPredictions;
+    std::istringstream in;
+
+    for (int64_t i = begin; i < end; i++)
+    {
+      in.clear();
+      in.str(sentences[i]);
+      dict_->getLine(in, words, labels);
+
+      modelPredictions.clear();
+      fastText_->predict(k, words, modelPredictions, state, 0.0001);
+
+      for (size_t j = 0; j < modelPredictions.size(); j++)
+      {
+        result.ids[i * k + j] = modelPredictions[j].second;
+        result.values[i * k + j] = exp(modelPredictions[j].first);
+      }
+    }
+  };
+
+  nthreads = batchThreads(nthreads, n);
+  if (nthreads == 1)
+  {
+    predictRange(0, n);
+    return result;
+  }
+
+  std::vector<std::thread> threads;
+  for (int32_t t = 0; t < nthreads; t++)
+  {
+    threads.push_back(std::thread(predictRange, t * n / nthreads, (t + 1) * n / nthreads));
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+  return result;
+}
+
+AbortFlag Wrapper::newJob()
+{
+  AbortFlag aborted = std::make_shared<std::atomic<bool>>(false);
+  std::lock_guard<std::mutex> lock(jobsMtx_);
+  jobs_.erase(std::remove_if(jobs_.begin(), jobs_.end(),
+                             [](const std::weak_ptr<std::atomic<bool>> &job) { return job.expired(); }),
+              jobs_.end());
+  jobs_.push_back(aborted);
+  return aborted;
+}
+
+void Wrapper::abort()
+{
+  std::lock_guard<std::mutex> lock(jobsMtx_);
+  for (const std::weak_ptr<std::atomic<bool>> &job : jobs_)
+  {
+    if (AbortFlag aborted = job.lock())
+    {
+      *aborted = true;
+    }
+  }
+}
+
+FastText::TrainCallback Wrapper::makeTrainCallback(FastText &fastText,
+                                                   const FastText::TrainCallback &callback,
+                                                   const AbortFlag &aborted)
+{
+  // fastText resets its abort state when threads start, so the request is
+  // forwarded from within the training threads instead.
+  return [&fastText, callback, aborted](float progress, float loss, double wst, double lr, int64_t eta) {
+    if (*aborted)
+    {
+      fastText.abort();
+      return;
+    }
+    if (callback)
+    {
+      callback(progress, loss, wst, lr, eta);
+    }
+  };
+}
+
+std::map<std::string, std::string> Wrapper::train(const std::vector<std::string> args,
+                                                  const std::string *corpus,
+                                                  std::string *modelBuffer,
+                                                  const FastText::TrainCallback &callback,
+                                                  AbortFlag aborted)
 {
   Args a;
   a.parseArgs(args);
+  if (!aborted)
+  {
+    aborted = newJob();
+  }
 
-  std::string inputFilename = a.input;
-  if (!fileExist(inputFilename))
+  if (!corpus && !fileExist(a.input))
   {
     throw "Input file is not exist.";
   }
 
   if (a.verbose > 0)
   {
-    std::cout << "Input  <<<<< " << a.input << std::endl;
-    std::cout << "Output >>>>> " << a.output + ".bin" << std::endl;
+    std::cout << "Input  <<<<< " << (corpus ? "in-memory corpus" : a.input) << std::endl;
+    std::cout << "Output >>>>> " << (modelBuffer ? "in-memory model" : a.output + ".bin") << std::endl;
   }
 
-  fastText_.train(a);
-  fastText_.saveModel();
-  fastText_.saveVectors();
-  return loadModel(a.output + ".bin");
+  // Training mutates the model, so it never runs on a shared registry instance.
+  std::shared_ptr<FastTextNapi> fastText = std::make_shared<FastTextNapi>();
+  FastText::TrainCallback trainCallback = makeTrainCallback(*fastText, callback, aborted);
+  if (corpus)
+  {
+    std::istringstream in(*corpus);
+    fastText->train(a, in, trainCallback);
+  }
+  else
+  {
+    fastText->train(a, trainCallback);
+  }
+
+  return useTrainedModel(fastText, modelBuffer);
 }
 
-std::map<std::string, std::string> Wrapper::quantize(const std::vector<std::string> args)
+std::map<std::string, std::string> Wrapper::autotune(const std::vector<std::string> args,
+                                                     const std::string *corpus,
+                                                     const std::string *validation,
+                                                     std::string *modelBuffer,
+                                                     const FastText::TrainCallback &callback,
+                                                     AbortFlag aborted)
 {
   Args a;
   a.parseArgs(args);
+  if (!aborted)
+  {
+    aborted = newJob();
+  }
+
+  if (a.model != model_name::sup)
+  {
+    throw "Autotune only supports supervised models.";
+  }
+  if (!corpus && !fileExist(a.input))
+  {
+    throw "Input file is not exist.";
+  }
+  if (!validation && !fileExist(a.autotuneValidationFile))
+  {
+    throw "Validation file is not exist.";
+  }
+
+  std::shared_ptr<FastTextNapi> fastText = std::make_shared<FastTextNapi>();
+  fasttext::Autotune autotune(fastText);
+  std::istringstream in(corpus ? *corpus : std::string());
+  std::unique_ptr<std::istream> validationIn;
+  if (validation)
+  {
+    validationIn.reset(new std::istringstream(*validation));
+  }
+  else
+  {
+    validationIn.reset(new std::ifstream(a.autotuneValidationFile));
+  }
+  autotune.train(a, *validationIn, corpus ? &in : nullptr, makeTrainCallback(*fastText, callback, aborted));
+
+  std::map<std::string, std::string> info = useTrainedModel(fastText, modelBuffer);
+  info["score"] = std::to_string(autotune.getBestScore());
+  return info;
+}
+
+std::map<std::string, std::string> Wrapper::useTrainedModel(std::shared_ptr<FastTextNapi> fastText,
+                                                            std::string *modelBuffer)
+{
+  if (!modelBuffer)
+  {
+    fastText->saveModel();
+    fastText->saveVectors();
+    return reloadModel(fastText->getArgs().output + (fastText->isQuant() ? ".ftz" : ".bin"));
+  }
+
+  std::ostringstream out;
+  fastText->saveModel(out);
+  *modelBuffer = out.str();
+
+  // The trained model is not backed by a file, so it is kept out of the registry.
+  std::lock_guard<std::mutex> lock(mtx_);
+  fastText_ = fastText;
+  setModel(fastText_->getModelInfo());
+  isLoaded_ = true;
+  return getModelInfo();
+}
+
+std::map<std::string, std::string> Wrapper::quantize(const std::vector<std::string> args,
+                                                     const FastText::TrainCallback &callback,
+                                                     AbortFlag aborted)
+{
+  Args a;
+  a.parseArgs(args);
+  if (!aborted)
+  {
+    aborted = newJob();
+  }
 
   if (!fileExist(a.input))
   {
@@ -343,8 +767,9 @@ std::map<std::string, std::string> Wrapper::quantize(const std::vector<std::stri
   }
 
   // parseArgs checks if a.output is given.
-  fastText_.loadModel(a.output + ".bin");
-  fastText_.quantize(a);
-  fastText_.saveModel();
-  return loadModel(a.output + ".ftz");
+  FastTextNapi fastText;
+  fastText.loadModel(a.output + ".bin");
+  fastText.quantize(a, makeTrainCallback(fastText, callback, aborted));
+  fastText.saveModel();
+  return reloadModel(a.output + ".ftz");
 }
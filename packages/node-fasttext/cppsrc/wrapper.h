@@ -10,9 +10,13 @@
 #include <set>
 #include <map>
 #include <mutex>
+#include <vector>
 
 #include "./fasttext_napi.h"
+#include "./model-registry.h"
+#include "./subword-cache.h"
 
+#include "../fastText/src/autotune.h"
 #include "../fastText/src/fasttext.h"
 #include "../fastText/src/quantmatrix.h"
 
@@ -23,6 +27,7 @@ using fasttext::FastText;
 using fasttext::Model;
 using fasttext::QuantMatrix;
 using fasttext::real;
+using fasttext::storage_type;
 using fasttext::Vector;
 
 struct PredictResult
@@ -31,6 +36,31 @@ struct PredictResult
   double value;
 };
 
+struct TrainProgress
+{
+  float progress;
+  float loss;
+  double wordsPerSecPerThread;
+  double lr;
+  int64_t eta;
+};
+
+/**
+ * Cancellation request of one train, quantize or autotune job.
+ */
+typedef std::shared_ptr<std::atomic<bool>> AbortFlag;
+
+/**
+ * Predictions of many sentences packed in flat arrays: the k best labels of
+ * sentence i are at [i * k, (i + 1) * k). Missing predictions have id -1.
+ */
+struct BatchPredictResult
+{
+  std::vector<std::string> labels;
+  std::vector<int32_t> ids;
+  std::vector<float> values;
+};
+
 class Wrapper
 {
 private:
@@ -38,8 +68,16 @@ private:
   std::shared_ptr<Dictionary> dict_;
 
   std::shared_ptr<Model> model_;
-  DenseMatrix wordVectors_;
-  FastTextNapi fastText_;
+  std::shared_ptr<const FastTextNapi> fastText_;
+
+  // nn index: normalized word vectors, or for product-quantized models only
+  // the word norms, the codes being scored through lookup tables instead.
+  std::unique_ptr<DenseMatrix> wordVectors_;
+  std::shared_ptr<const QuantMatrix> quantInput_;
+  std::vector<real> wordNorms_;
+
+  std::unique_ptr<SubwordCache> subwordCache_;
+  int64_t inputRows_;
 
   // std::atomic<int64_t> tokenCount;
   // clock_t start;
@@ -49,31 +87,121 @@ private:
 
   std::vector<PredictResult> findNN(const Vector &, int32_t,
                                     const std::set<std::string> &);
+  void setModel(const ModelInfo &);
+  std::vector<PredictResult> predictWords(const std::vector<int32_t> &words, int32_t k);
 
-  std::map<std::string, std::string> loadModel(std::istream &);
+  void loadModel(FastTextNapi &, const std::string &);
+  // Called with mtx_ held: sets fastText_ to the registry model of filename.
+  void acquireModel(const std::string &filename);
+  // Replaces the current model, even when loaded, by the one of filename
+  // (e.g. the output of a training).
+  std::map<std::string, std::string> reloadModel(const std::string &filename);
 
   bool quant_;
   std::string modelFilename_;
+  storage_type inputStorage_;
+  // Threads reading the matrices of the model file, and what the last
+  // loadModel read (nothing when the model was shared from the registry).
+  int32_t loadThreads_;
+  int64_t loadBytes_;
+  double loadSeconds_;
   std::mutex mtx_;
   std::mutex precomputeMtx_;
 
   bool isLoaded_;
   bool isPrecomputed_;
+  // Flags of the queued and running jobs, which abort() sets.
+  std::mutex jobsMtx_;
+  std::vector<std::weak_ptr<std::atomic<bool>>> jobs_;
 
   bool isModelLoaded() { return isLoaded_; }
   bool fileExist(const std::string &filename);
   std::map<std::string, std::string> getModelInfo();
+  FastText::TrainCallback makeTrainCallback(FastText &, const FastText::TrainCallback &, const AbortFlag &);
+  std::map<std::string, std::string> useTrainedModel(std::shared_ptr<FastTextNapi> fastText,
+                                                     std::string *modelBuffer);
 
 public:
-  Wrapper(std::string modelFilename);
+  /**
+   * inputStorage other than fp32 keeps the input matrix of the loaded model in
+   * 16 bits, halving its memory; such models can be queried but not retrained.
+   */
+  Wrapper(std::string modelFilename, storage_type inputStorage = storage_type::fp32);
 
   void getVector(Vector &, const std::string &);
 
+  /**
+   * Bounds the memo of out-of-vocabulary subwords (0 disables it). Not thread
+   * safe, call it before querying.
+   */
+  void setSubwordCacheSize(size_t capacity);
+
+  /**
+   * Number of threads reading the matrices of the model file, each from its
+   * own range of the file. Call it before loading.
+   */
+  void setLoadThreads(int32_t nthreads);
+
+  /**
+   * Memoizes the subwords of the out-of-vocabulary tokens among the given ones
+   * (e.g. a bot vocabulary), returns how many were added.
+   */
+  size_t prewarm(const std::vector<std::string> &tokens);
+
   std::vector<PredictResult> predict(std::string sentence, int32_t k);
+
+  /**
+   * Input rows (words, subwords and word n-grams) of already tokenized text,
+   * to be fed to predict(ids, k) any number of times without re-hashing.
+   */
+  std::vector<int32_t> getIds(const std::vector<std::string> &tokens);
+  std::vector<PredictResult> predict(const std::vector<int32_t> &ids, int32_t k);
+  BatchPredictResult predictBatch(const std::vector<std::string> &sentences, int32_t k, int32_t nthreads);
   std::vector<PredictResult> nn(std::string query, int32_t k);
+
+  /**
+   * Weighted average of the unit word vectors of each utterance, packed in one
+   * array (dim values per utterance). Tokens with a null vector are skipped,
+   * weights default to 1 and utterances without any vector are all zeros.
+   */
+  std::vector<float> getSentenceVectors(const std::vector<std::vector<std::string>> &utterances,
+                                        const std::vector<std::vector<float>> *weights,
+                                        int32_t nthreads);
   std::vector<double> getWordVector(std::string query);
-  std::map<std::string, std::string> train(const std::vector<std::string> args);
-  std::map<std::string, std::string> quantize(const std::vector<std::string> args);
+  std::map<std::string, std::string> train(const std::vector<std::string> args,
+                                           const std::string *corpus = nullptr,
+                                           std::string *modelBuffer = nullptr,
+                                           const FastText::TrainCallback &callback = {},
+                                           AbortFlag aborted = nullptr);
+  std::map<std::string, std::string> quantize(const std::vector<std::string> args,
+                                              const FastText::TrainCallback &callback = {},
+                                              AbortFlag aborted = nullptr);
+
+  /**
+   * Searches the training arguments of a supervised model scoring best on the
+   * validation set (args' autotune-validation file when null) within the
+   * autotune duration, quantizing to the autotune model size when given.
+   * Corpus and output are handled as by train; the model info holds the
+   * selected arguments and their validation score.
+   */
+  std::map<std::string, std::string> autotune(const std::vector<std::string> args,
+                                              const std::string *corpus = nullptr,
+                                              const std::string *validation = nullptr,
+                                              std::string *modelBuffer = nullptr,
+                                              const FastText::TrainCallback &callback = {},
+                                              AbortFlag aborted = nullptr);
+
+  /**
+   * Registers a job (queued when the flag is created) that abort() cancels
+   * until the flag is released. Jobs given no flag register one when they start.
+   */
+  AbortFlag newJob();
+
+  /**
+   * Stops the queued and running trainings of this wrapper, which then fail
+   * with "Aborted.". Jobs registered afterwards are not affected.
+   */
+  void abort();
 
   void precomputeWordVectors();
   std::map<std::string, std::string> loadModel();
@@ -39,6 +39,9 @@ Args::Args() {
   pretrainedVectors = "";
   saveOutput = false;
   seed = 0;
+  inMemory = false;
+  shuffle = false;
+  deterministic = false;
 
   qout = false;
   retrain = false;
@@ -188,6 +191,15 @@ void Args::parseArgs(const std::vector<std::string>& args) {
         ai--;
       } else if (args[ai] == "-seed") {
         seed = std::stoi(args.at(ai + 1));
+      } else if (args[ai] == "-inMemory") {
+        inMemory = true;
+        ai--;
+      } else if (args[ai] == "-shuffle") {
+        shuffle = true;
+        ai--;
+      } else if (args[ai] == "-deterministic") {
+        deterministic = true;
+        ai--;
       } else if (args[ai] == "-qnorm") {
         qnorm = true;
         ai--;
@@ -288,7 +300,15 @@ void Args::printTrainingHelp() {
       << pretrainedVectors << "]\n"
       << "  -saveOutput         whether output params should be saved ["
       << boolToString(saveOutput) << "]\n"
-      << "  -seed               random generator seed  [" << seed << "]\n";
+      << "  -seed               random generator seed  [" << seed << "]\n"
+      << "  -inMemory           tokenize the input once and train from memory ["
+      << boolToString(inMemory) << "]\n"
+      << "  -shuffle            shuffle the lines of each thread every epoch "
+         "(in-memory corpus only) ["
+      << boolToString(shuffle) << "]\n"
+      << "  -deterministic      reproducible training with several threads, "
+         "updates are merged in a fixed order ["
+      << boolToString(deterministic) << "]\n";
 }
 
 void Args::printAutotuneHelp() {
@@ -59,6 +59,9 @@ class Args {
   std::string pretrainedVectors;
   bool saveOutput;
   int seed;
+  bool inMemory;
+  bool shuffle;
+  bool deterministic;
 
   bool qout;
   bool retrain;
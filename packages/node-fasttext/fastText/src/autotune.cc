@@ -215,6 +215,10 @@ Autotune::Autotune(const std::shared_ptr<FastText>& fastText)
       strategy_(),
       timer_() {}
 
+Autotune::~Autotune() noexcept {
+  stopTimer();
+}
+
 void Autotune::printInfo(double maxDuration) {
   double progress = elapsed_ * 100 / maxDuration;
   progress = std::min(progress, 100.0);
@@ -237,12 +241,15 @@ void Autotune::printInfo(double maxDuration) {
 
 void Autotune::timer(
     const std::chrono::steady_clock::time_point& start,
-    double maxDuration) {
+    double maxDuration,
+    int verbose) {
   elapsed_ = 0.0;
   while (keepTraining(maxDuration)) {
     std::this_thread::sleep_for(std::chrono::milliseconds(500));
     elapsed_ = utils::getDuration(start, std::chrono::steady_clock::now());
-    printInfo(maxDuration);
+    if (verbose > 0) {
+      printInfo(maxDuration);
+    }
   }
   abort();
 }
@@ -261,17 +268,18 @@ void Autotune::abort() {
 void Autotune::startTimer(const Args& args) {
   std::chrono::steady_clock::time_point start =
       std::chrono::steady_clock::now();
-  timer_ = std::thread([=]() { timer(start, args.autotuneDuration); });
   bestScore_ = kUnknownBestScore;
   trials_ = 0;
   continueTraining_ = true;
+  timer_ = std::thread(
+      [=]() { timer(start, args.autotuneDuration, args.verbose); });
+}
 
-  auto previousSignalHandler = std::signal(SIGINT, signalHandler);
-  interruptSignalHandler = [&]() {
-    std::signal(SIGINT, previousSignalHandler);
-    std::cerr << std::endl << "Aborting autotune..." << std::endl;
-    abort();
-  };
+void Autotune::stopTimer() {
+  continueTraining_ = false;
+  if (timer_.joinable()) {
+    timer_.join();
+  }
 }
 
 double Autotune::getMetricScore(
@@ -341,7 +349,11 @@ int Autotune::getCutoffForFileSize(
   return std::max(cutoff, kCutoffLimit);
 }
 
-bool Autotune::quantize(Args& args, const Args& autotuneArgs) {
+bool Autotune::quantize(
+    Args& args,
+    const Args& autotuneArgs,
+    std::istream* in,
+    const FastText::TrainCallback& callback) {
   if (autotuneArgs.getAutotuneModelSize() == Args::kUnlimitedModelSize) {
     return true;
   }
@@ -356,11 +368,28 @@ bool Autotune::quantize(Args& args, const Args& autotuneArgs) {
   if (args.cutoff == kCutoffLimit) {
     return false;
   }
-  fastText_->quantize(args);
+  if (in) {
+    fastText_->quantize(args, *in, callback);
+  } else {
+    fastText_->quantize(args, callback);
+  }
 
   return true;
 }
 
+void Autotune::trainModel(
+    const Args& args,
+    std::istream* in,
+    const FastText::TrainCallback& callback) {
+  if (in) {
+    in->clear();
+    in->seekg(0, std::ios_base::beg);
+    fastText_->train(args, *in, callback);
+  } else {
+    fastText_->train(args, callback);
+  }
+}
+
 void Autotune::printSkippedArgs(const Args& autotuneArgs) {
   std::unordered_set<std::string> argsToCheck = {"epoch",
                                                  "lr",
@@ -380,14 +409,37 @@ void Autotune::printSkippedArgs(const Args& autotuneArgs) {
   }
 }
 
+double Autotune::getBestScore() const {
+  return bestScore_;
+}
+
 void Autotune::train(const Args& autotuneArgs) {
   std::ifstream validationFileStream(autotuneArgs.autotuneValidationFile);
   if (!validationFileStream.is_open()) {
     throw std::invalid_argument("Validation file cannot be opened!");
   }
-  printSkippedArgs(autotuneArgs);
+
+  auto previousSignalHandler = std::signal(SIGINT, signalHandler);
+  interruptSignalHandler = [this, previousSignalHandler]() {
+    std::signal(SIGINT, previousSignalHandler);
+    std::cerr << std::endl << "Aborting autotune..." << std::endl;
+    abort();
+  };
+  train(autotuneArgs, validationFileStream, nullptr);
+  std::signal(SIGINT, previousSignalHandler);
+}
+
+void Autotune::train(
+    const Args& autotuneArgs,
+    std::istream& validation,
+    std::istream* in,
+    const FastText::TrainCallback& callback) {
+  if (autotuneArgs.verbose > 0) {
+    printSkippedArgs(autotuneArgs);
+  }
 
   bool sizeConstraintWarning = false;
+  bool cancelled = false;
   int verbose = autotuneArgs.verbose;
   Args bestTrainArgs(autotuneArgs);
   Args trainArgs(autotuneArgs);
@@ -405,13 +457,13 @@ void Autotune::train(const Args& autotuneArgs) {
     ElapsedTimeMarker elapsedTimeMarker;
     double currentScore = std::numeric_limits<double>::quiet_NaN();
     try {
-      fastText_->train(trainArgs);
-      bool sizeConstraintOK = quantize(trainArgs, autotuneArgs);
+      trainModel(trainArgs, in, callback);
+      bool sizeConstraintOK = quantize(trainArgs, autotuneArgs, in, callback);
       if (sizeConstraintOK) {
         const auto& metricLabel = autotuneArgs.getAutotuneMetricLabel();
         Meter meter(!metricLabel.empty());
         fastText_->test(
-            validationFileStream, autotuneArgs.autotunePredictions, 0.0, meter);
+            validation, autotuneArgs.autotunePredictions, 0.0, meter);
 
         currentScore = getMetricScore(
             meter,
@@ -429,10 +481,13 @@ void Autotune::train(const Args& autotuneArgs) {
         if (!sizeConstraintWarning && trials_ > 10 &&
             sizeConstraintFailed_ > (trials_ / 2)) {
           sizeConstraintWarning = true;
-          std::cerr << std::endl
-                    << "Warning : requested model size is probably too small. "
-                       "You may want to increase `autotune-modelsize`."
-                    << std::endl;
+          if (verbose > 0) {
+            std::cerr
+                << std::endl
+                << "Warning : requested model size is probably too small. "
+                   "You may want to increase `autotune-modelsize`."
+                << std::endl;
+          }
         }
       }
     } catch (DenseMatrix::EncounteredNaNError&) {
@@ -442,14 +497,25 @@ void Autotune::train(const Args& autotuneArgs) {
     } catch (TimeoutError&) {
       break;
     } catch (FastText::AbortError&) {
+      // Our own abort (timeout, SIGINT) stops training first.
+      cancelled = continueTraining_;
       break;
+    } catch (...) {
+      // e.g. an empty corpus: the timer must not outlive the search.
+      stopTimer();
+      throw;
     }
     LOG_VAL_NAN(currentScore, currentScore)
     LOG_VAL(train took, elapsedTimeMarker.getElapsed())
   }
-  if (timer_.joinable()) {
+  if (cancelled) {
+    stopTimer();
+  } else if (timer_.joinable()) {
     timer_.join();
   }
+  if (cancelled) {
+    throw FastText::AbortError();
+  }
 
   if (bestScore_ == kUnknownBestScore) {
     std::string errorMessage;
@@ -464,13 +530,15 @@ void Autotune::train(const Args& autotuneArgs) {
     }
     throw std::runtime_error(errorMessage);
   } else {
-    std::cerr << std::endl;
-    std::cerr << "Training again with best arguments" << std::endl;
+    if (verbose > 0) {
+      std::cerr << std::endl;
+      std::cerr << "Training again with best arguments" << std::endl;
+    }
     bestTrainArgs.verbose = verbose;
     LOG_VAL(Best selected args, 0)
     printArgs(bestTrainArgs, autotuneArgs);
-    fastText_->train(bestTrainArgs);
-    quantize(bestTrainArgs, autotuneArgs);
+    trainModel(bestTrainArgs, in, callback);
+    quantize(bestTrainArgs, autotuneArgs, in, callback);
   }
 }
 
@@ -55,9 +55,11 @@ class Autotune {
   void printInfo(double maxDuration);
   void timer(
       const std::chrono::steady_clock::time_point& start,
-      double maxDuration);
+      double maxDuration,
+      int verbose);
   void abort();
   void startTimer(const Args& args);
+  void stopTimer();
   double getMetricScore(
       Meter& meter,
       const metric_name& metricName,
@@ -65,7 +67,15 @@ class Autotune {
       const std::string& metricLabel) const;
   void printArgs(const Args& args, const Args& autotuneArgs);
   void printSkippedArgs(const Args& autotuneArgs);
-  bool quantize(Args& args, const Args& autotuneArgs);
+  void trainModel(
+      const Args& args,
+      std::istream* in,
+      const FastText::TrainCallback& callback);
+  bool quantize(
+      Args& args,
+      const Args& autotuneArgs,
+      std::istream* in,
+      const FastText::TrainCallback& callback);
   int getCutoffForFileSize(bool qout, bool qnorm, int dsub, int64_t fileSize)
       const;
 
@@ -81,9 +91,21 @@ class Autotune {
   Autotune(Autotune&&) = delete;
   Autotune& operator=(const Autotune&) = delete;
   Autotune& operator=(Autotune&&) = delete;
-  ~Autotune() noexcept = default;
+  ~Autotune() noexcept;
 
   void train(const Args& args);
+
+  // Searches with an already opened validation set, training on `in` when
+  // given (an in-memory corpus) or on args.input. SIGINT is left alone: the
+  // search is cancelled by aborting from the callback, which then throws
+  // FastText::AbortError instead of keeping the best trial.
+  void train(
+      const Args& args,
+      std::istream& validation,
+      std::istream* in,
+      const FastText::TrainCallback& callback = {});
+
+  double getBestScore() const;
 };
 
 } // namespace fasttext
@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "corpus.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace fasttext {
+
+Corpus::Corpus(std::shared_ptr<const Dictionary> dict, model_name model)
+    : dict_(dict), model_(model) {}
+
+void Corpus::load(std::istream& in) {
+  std::vector<int32_t> words, labels;
+  words_.clear();
+  labels_.clear();
+  wordOffsets_.assign(1, 0);
+  labelOffsets_.assign(1, 0);
+  ntokens_.clear();
+
+  // Supervised lines keep their subword and word ngram ids; unsupervised
+  // lines keep every in-vocabulary word so that subsampling can still be
+  // drawn anew on each pass.
+  while (in.peek() != EOF) {
+    int32_t ntokens;
+    if (model_ == model_name::sup) {
+      ntokens = dict_->getLine(in, words, labels);
+    } else {
+      ntokens = dict_->getLine(in, words);
+      labels.clear();
+    }
+    words_.insert(words_.end(), words.cbegin(), words.cend());
+    labels_.insert(labels_.end(), labels.cbegin(), labels.cend());
+    wordOffsets_.push_back(words_.size());
+    labelOffsets_.push_back(labels_.size());
+    ntokens_.push_back(ntokens);
+  }
+  words_.shrink_to_fit();
+  labels_.shrink_to_fit();
+
+  if (ntokens_.empty()) {
+    throw std::invalid_argument("Empty training corpus.");
+  }
+}
+
+int64_t Corpus::nlines() const {
+  return ntokens_.size();
+}
+
+int32_t Corpus::getLine(
+    int64_t line,
+    std::vector<int32_t>& words,
+    std::vector<int32_t>& labels) const {
+  words.assign(
+      words_.cbegin() + wordOffsets_[line],
+      words_.cbegin() + wordOffsets_[line + 1]);
+  labels.assign(
+      labels_.cbegin() + labelOffsets_[line],
+      labels_.cbegin() + labelOffsets_[line + 1]);
+  return ntokens_[line];
+}
+
+int32_t Corpus::getLine(
+    int64_t line,
+    std::vector<int32_t>& words,
+    std::minstd_rand& rng) const {
+  std::uniform_real_distribution<> uniform(0, 1);
+  words.clear();
+  for (int64_t i = wordOffsets_[line]; i < wordOffsets_[line + 1]; i++) {
+    if (!dict_->discard(words_[i], uniform(rng))) {
+      words.push_back(words_[i]);
+    }
+  }
+  return ntokens_[line];
+}
+
+Corpus::Shard::Shard(
+    const Corpus& corpus,
+    int32_t shardId,
+    int32_t nshards,
+    bool shuffle,
+    int32_t seed)
+    : shuffle_(shuffle), rng_(shardId + seed) {
+  const int64_t n = corpus.nlines();
+  if (n >= nshards) {
+    begin_ = shardId * n / nshards;
+    end_ = (shardId + 1) * n / nshards;
+  } else {
+    // More threads than lines: threads share the lines one each.
+    begin_ = shardId % n;
+    end_ = begin_ + 1;
+  }
+  cursor_ = end_ - begin_;
+  if (shuffle_) {
+    order_.resize(end_ - begin_);
+    std::iota(order_.begin(), order_.end(), begin_);
+  }
+}
+
+int64_t Corpus::Shard::next() {
+  if (cursor_ >= end_ - begin_) {
+    cursor_ = 0;
+    if (shuffle_) {
+      std::shuffle(order_.begin(), order_.end(), rng_);
+    }
+  }
+  int64_t i = cursor_++;
+  return shuffle_ ? order_[i] : begin_ + i;
+}
+
+} // namespace fasttext
@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <istream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "args.h"
+#include "dictionary.h"
+
+namespace fasttext {
+
+// A training corpus tokenized once into contiguous id arrays, so that
+// training threads iterate over ids instead of re-reading and re-tokenizing
+// the input every epoch.
+class Corpus {
+ protected:
+  std::shared_ptr<const Dictionary> dict_;
+  model_name model_;
+
+  std::vector<int32_t> words_;
+  std::vector<int32_t> labels_;
+  std::vector<int64_t> wordOffsets_;
+  std::vector<int64_t> labelOffsets_;
+  std::vector<int32_t> ntokens_;
+
+ public:
+  Corpus(std::shared_ptr<const Dictionary>, model_name);
+
+  void load(std::istream&);
+  int64_t nlines() const;
+
+  int32_t getLine(int64_t, std::vector<int32_t>&, std::vector<int32_t>&)
+      const;
+  int32_t getLine(int64_t, std::vector<int32_t>&, std::minstd_rand&) const;
+
+  // The contiguous slice of lines read by one training thread, visited in a
+  // new random order on each pass when shuffling.
+  class Shard {
+   protected:
+    int64_t begin_;
+    int64_t end_;
+    int64_t cursor_;
+    bool shuffle_;
+    std::vector<int64_t> order_;
+    std::minstd_rand rng_;
+
+   public:
+    Shard(const Corpus&, int32_t, int32_t, bool, int32_t);
+
+    int64_t next();
+  };
+};
+
+} // namespace fasttext
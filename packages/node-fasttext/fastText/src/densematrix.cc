@@ -13,6 +13,7 @@
 #include <thread>
 #include <utility>
 #include "utils.h"
+#include "vecmath.h"
 #include "vector.h"
 
 namespace fasttext {
@@ -65,9 +66,7 @@ void DenseMatrix::multiplyRow(const Vector& nums, int64_t ib, int64_t ie) {
   for (auto i = ib; i < ie; i++) {
     real n = nums[i - ib];
     if (n != 0) {
-      for (auto j = 0; j < n_; j++) {
-        at(i, j) *= n;
-      }
+      vecmath::scale(n, data_.data() + i * n_, n_);
     }
   }
 }
@@ -109,10 +108,7 @@ real DenseMatrix::dotRow(const Vector& vec, int64_t i) const {
   assert(i >= 0);
   assert(i < m_);
   assert(vec.size() == n_);
-  real d = 0.0;
-  for (int64_t j = 0; j < n_; j++) {
-    d += at(i, j) * vec[j];
-  }
+  real d = vecmath::dot(data_.data() + i * n_, vec.data(), n_);
   if (std::isnan(d)) {
     throw EncounteredNaNError();
   }
@@ -123,27 +119,21 @@ void DenseMatrix::addVectorToRow(const Vector& vec, int64_t i, real a) {
   assert(i >= 0);
   assert(i < m_);
   assert(vec.size() == n_);
-  for (int64_t j = 0; j < n_; j++) {
-    data_[i * n_ + j] += a * vec[j];
-  }
+  vecmath::axpy(a, vec.data(), data_.data() + i * n_, n_);
 }
 
 void DenseMatrix::addRowToVector(Vector& x, int32_t i) const {
   assert(i >= 0);
   assert(i < this->size(0));
   assert(x.size() == this->size(1));
-  for (int64_t j = 0; j < n_; j++) {
-    x[j] += at(i, j);
-  }
+  vecmath::add(data_.data() + i * n_, x.data(), n_);
 }
 
 void DenseMatrix::addRowToVector(Vector& x, int32_t i, real a) const {
   assert(i >= 0);
   assert(i < this->size(0));
   assert(x.size() == this->size(1));
-  for (int64_t j = 0; j < n_; j++) {
-    x[j] += a * at(i, j);
-  }
+  vecmath::axpy(a, data_.data() + i * n_, x.data(), n_);
 }
 
 void DenseMatrix::save(std::ostream& out) const {
@@ -159,6 +149,30 @@ void DenseMatrix::load(std::istream& in) {
   in.read((char*)data_.data(), m_ * n_ * sizeof(real));
 }
 
+void DenseMatrix::load(
+    std::istream& in,
+    const std::string& filename,
+    int32_t nthreads) {
+  if (nthreads <= 1) {
+    load(in);
+    return;
+  }
+  in.read((char*)&m_, sizeof(int64_t));
+  in.read((char*)&n_, sizeof(int64_t));
+  data_ = std::vector<real>(m_ * n_);
+  int64_t offset = in.tellg();
+  utils::readParallel(
+      filename,
+      offset,
+      m_ * n_,
+      sizeof(real),
+      nthreads,
+      [this](std::istream& ifs, int64_t begin, int64_t end) {
+        ifs.read((char*)(data_.data() + begin), (end - begin) * sizeof(real));
+      });
+  in.seekg(std::streampos(offset + m_ * n_ * sizeof(real)));
+}
+
 void DenseMatrix::dump(std::ostream& out) const {
   out << m_ << " " << n_ << std::endl;
   for (int64_t i = 0; i < m_; i++) {
@@ -73,6 +73,8 @@ class DenseMatrix : public Matrix {
   void addRowToVector(Vector& x, int32_t i, real a) const override;
   void save(std::ostream&) const override;
   void load(std::istream&) override;
+  void load(std::istream& in, const std::string& filename, int32_t nthreads)
+      override;
   void dump(std::ostream&) const override;
 
   class EncounteredNaNError : public std::runtime_error {
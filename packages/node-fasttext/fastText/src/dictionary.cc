@@ -25,7 +25,7 @@ const std::string Dictionary::EOW = ">";
 
 Dictionary::Dictionary(std::shared_ptr<Args> args)
     : args_(args),
-      word2int_(MAX_VOCAB_SIZE, -1),
+      word2int_(MIN_TABLE_SIZE, -1),
       size_(0),
       nwords_(0),
       nlabels_(0),
@@ -55,7 +55,30 @@ int32_t Dictionary::find(const std::string& w, uint32_t h) const {
   return id;
 }
 
+// word2int_ is an open-addressing table. It starts small and grows on demand
+// (up to MAX_VOCAB_SIZE) so that small supervised models do not pay for
+// 30M empty slots, and is compacted to the vocabulary size once the words
+// are known (threshold, prune and load).
+void Dictionary::rehash(int32_t tableSize) {
+  word2int_.assign(std::max(tableSize, MIN_TABLE_SIZE), -1);
+  for (int32_t i = 0; i < words_.size(); i++) {
+    word2int_[find(words_[i].word)] = i;
+  }
+}
+
+void Dictionary::reserve(int32_t n) {
+  int32_t tableSize = word2int_.size();
+  if (n < 0.7 * tableSize || tableSize >= MAX_VOCAB_SIZE) {
+    return;
+  }
+  while (n >= 0.7 * tableSize && tableSize < MAX_VOCAB_SIZE) {
+    tableSize = std::min<int64_t>(2 * int64_t(tableSize), MAX_VOCAB_SIZE);
+  }
+  rehash(tableSize);
+}
+
 void Dictionary::add(const std::string& w) {
+  reserve(size_ + 1);
   int32_t h = find(w);
   ntokens_++;
   if (word2int_[h] == -1) {
@@ -275,13 +298,11 @@ void Dictionary::threshold(int64_t t, int64_t tl) {
           }),
       words_.end());
   words_.shrink_to_fit();
-  size_ = 0;
+  size_ = words_.size();
   nwords_ = 0;
   nlabels_ = 0;
-  std::fill(word2int_.begin(), word2int_.end(), -1);
+  rehash(std::ceil(size_ / 0.7));
   for (auto it = words_.begin(); it != words_.end(); ++it) {
-    int32_t h = find(it->word);
-    word2int_[h] = size_++;
     if (it->type == entry_type::word) {
       nwords_++;
     }
@@ -352,6 +373,19 @@ int32_t Dictionary::getLine(
     std::vector<int32_t>& words,
     std::minstd_rand& rng) const {
   std::uniform_real_distribution<> uniform(0, 1);
+  int32_t ntokens = getLine(in, words);
+  size_t kept = 0;
+  for (size_t i = 0; i < words.size(); i++) {
+    if (!discard(words[i], uniform(rng))) {
+      words[kept++] = words[i];
+    }
+  }
+  words.resize(kept);
+  return ntokens;
+}
+
+int32_t Dictionary::getLine(std::istream& in, std::vector<int32_t>& words)
+    const {
   std::string token;
   int32_t ntokens = 0;
 
@@ -365,7 +399,7 @@ int32_t Dictionary::getLine(
     }
 
     ntokens++;
-    if (getType(wid) == entry_type::word && !discard(wid, uniform(rng))) {
+    if (getType(wid) == entry_type::word) {
       words.push_back(wid);
     }
     if (ntokens > MAX_LINE_SIZE || token == EOS) {
@@ -406,6 +440,35 @@ int32_t Dictionary::getLine(
   return ntokens;
 }
 
+int32_t Dictionary::getLine(
+    const std::vector<std::string>& tokens,
+    std::vector<int32_t>& words,
+    std::vector<int32_t>& labels) const {
+  std::vector<int32_t> word_hashes;
+  int32_t ntokens = 0;
+
+  words.clear();
+  labels.clear();
+  for (const std::string& token : tokens) {
+    uint32_t h = hash(token);
+    int32_t wid = getId(token, h);
+    entry_type type = wid < 0 ? getType(token) : getType(wid);
+
+    ntokens++;
+    if (type == entry_type::word) {
+      addSubwords(words, token, wid);
+      word_hashes.push_back(h);
+    } else if (type == entry_type::label && wid >= 0) {
+      labels.push_back(wid - nwords_);
+    }
+    if (token == EOS) {
+      break;
+    }
+  }
+  addWordNgrams(words, word_hashes, args_->wordNgrams);
+  return ntokens;
+}
+
 void Dictionary::pushHash(std::vector<int32_t>& hashes, int32_t id) const {
   if (pruneidx_size_ == 0 || id < 0) {
     return;
@@ -474,12 +537,7 @@ void Dictionary::load(std::istream& in) {
   }
   initTableDiscard();
   initNgrams();
-
-  int32_t word2intsize = std::ceil(size_ / 0.7);
-  word2int_.assign(word2intsize, -1);
-  for (int32_t i = 0; i < size_; i++) {
-    word2int_[find(words_[i].word)] = i;
-  }
+  rehash(std::ceil(size_ / 0.7));
 }
 
 void Dictionary::init() {
@@ -509,20 +567,18 @@ void Dictionary::prune(std::vector<int32_t>& idx) {
   }
   pruneidx_size_ = pruneidx_.size();
 
-  std::fill(word2int_.begin(), word2int_.end(), -1);
-
   int32_t j = 0;
   for (int32_t i = 0; i < words_.size(); i++) {
     if (getType(i) == entry_type::label ||
         (j < words.size() && words[j] == i)) {
       words_[j] = words_[i];
-      word2int_[find(words_[j].word)] = j;
       j++;
     }
   }
   nwords_ = words.size();
   size_ = nwords_ + nlabels_;
   words_.erase(words_.begin() + size_, words_.end());
+  rehash(std::ceil(size_ / 0.7));
   initNgrams();
 }
 
@@ -34,12 +34,15 @@ struct entry {
 class Dictionary {
  protected:
   static const int32_t MAX_VOCAB_SIZE = 30000000;
+  static const int32_t MIN_TABLE_SIZE = 1024;
   static const int32_t MAX_LINE_SIZE = 1024;
 
   int32_t find(const std::string&) const;
   int32_t find(const std::string&, uint32_t h) const;
   void initTableDiscard();
   void initNgrams();
+  void rehash(int32_t);
+  void reserve(int32_t);
   void reset(std::istream&) const;
   void pushHash(std::vector<int32_t>&, int32_t) const;
   void addSubwords(std::vector<int32_t>&, const std::string&, int32_t) const;
@@ -99,6 +102,11 @@ class Dictionary {
       const;
   int32_t getLine(std::istream&, std::vector<int32_t>&, std::minstd_rand&)
       const;
+  int32_t getLine(std::istream&, std::vector<int32_t>&) const;
+  int32_t getLine(
+      const std::vector<std::string>&,
+      std::vector<int32_t>&,
+      std::vector<int32_t>&) const;
   void threshold(int64_t, int64_t);
   void prune(std::vector<int32_t>&);
   bool isPruned() {
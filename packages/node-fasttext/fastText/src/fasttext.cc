@@ -47,8 +47,18 @@ std::shared_ptr<Loss> FastText::createLoss(std::shared_ptr<Matrix>& output) {
   }
 }
 
+namespace {
+
+// Tokens each thread trains on between two merges in deterministic mode.
+constexpr int64_t kRoundTokens = 1024;
+
+} // namespace
+
 FastText::FastText()
-    : quant_(false), wordVectors_(nullptr), trainException_(nullptr) {}
+    : quant_(false),
+      wordVectors_(nullptr),
+      trainException_(nullptr),
+      stopRounds_(false) {}
 
 void FastText::addInputVector(Vector& vec, int32_t ind) const {
   vec.addRow(*input_, ind);
@@ -67,7 +77,11 @@ std::shared_ptr<const DenseMatrix> FastText::getInputMatrix() const {
     throw std::runtime_error("Can't export quantized matrix");
   }
   assert(input_.get());
-  return std::dynamic_pointer_cast<DenseMatrix>(input_);
+  auto input = std::dynamic_pointer_cast<DenseMatrix>(input_);
+  if (!input) {
+    throw std::runtime_error("Can't export half-precision matrix");
+  }
+  return input;
 }
 
 void FastText::setMatrices(
@@ -109,7 +123,17 @@ int32_t FastText::getLabelId(const std::string& label) const {
 }
 
 void FastText::getWordVector(Vector& vec, const std::string& word) const {
-  const std::vector<int32_t>& ngrams = dict_->getSubwords(word);
+  int32_t i = dict_->getId(word);
+  if (i >= 0) {
+    getWordVector(vec, dict_->getSubwords(i));
+  } else {
+    getWordVector(vec, dict_->getSubwords(word));
+  }
+}
+
+void FastText::getWordVector(
+    Vector& vec,
+    const std::vector<int32_t>& ngrams) const {
   vec.zero();
   for (int i = 0; i < ngrams.size(); i++) {
     addInputVector(vec, ngrams[i]);
@@ -194,23 +218,29 @@ void FastText::saveModel(const std::string& filename) {
   if (!ofs.is_open()) {
     throw std::invalid_argument(filename + " cannot be opened for saving!");
   }
+  saveModel(ofs);
+  ofs.close();
+}
+
+void FastText::saveModel(std::ostream& out) {
   if (!input_ || !output_) {
     throw std::runtime_error("Model never trained");
   }
-  signModel(ofs);
-  args_->save(ofs);
-  dict_->save(ofs);
-
-  ofs.write((char*)&(quant_), sizeof(bool));
-  input_->save(ofs);
+  signModel(out);
+  args_->save(out);
+  dict_->save(out);
 
-  ofs.write((char*)&(args_->qout), sizeof(bool));
-  output_->save(ofs);
+  out.write((char*)&(quant_), sizeof(bool));
+  input_->save(out);
 
-  ofs.close();
+  out.write((char*)&(args_->qout), sizeof(bool));
+  output_->save(out);
 }
 
-void FastText::loadModel(const std::string& filename) {
+void FastText::loadModel(
+    const std::string& filename,
+    storage_type inputStorage,
+    int32_t nthreads) {
   std::ifstream ifs(filename, std::ifstream::binary);
   if (!ifs.is_open()) {
     throw std::invalid_argument(filename + " cannot be opened for loading!");
@@ -218,7 +248,7 @@ void FastText::loadModel(const std::string& filename) {
   if (!checkModel(ifs)) {
     throw std::invalid_argument(filename + " has wrong file format!");
   }
-  loadModel(ifs);
+  loadModel(ifs, inputStorage, filename, nthreads);
   ifs.close();
 }
 
@@ -236,7 +266,33 @@ void FastText::buildModel() {
   model_ = std::make_shared<Model>(input_, output_, loss, normalizeGradient);
 }
 
-void FastText::loadModel(std::istream& in) {
+void FastText::buildTrainModel(const std::shared_ptr<Matrix>& input) {
+  bool normalizeGradient = (args_->model == model_name::sup);
+  stagedInput_.reset();
+  stagedOutput_.reset();
+  if (args_->deterministic && args_->thread > 1) {
+    stagedInput_ = std::make_shared<StagedMatrix>(
+        std::dynamic_pointer_cast<DenseMatrix>(input), args_->thread);
+    stagedOutput_ = std::make_shared<StagedMatrix>(
+        std::dynamic_pointer_cast<DenseMatrix>(output_), args_->thread);
+    auto loss = createLoss(stagedOutput_);
+    model_ = std::make_shared<Model>(
+        stagedInput_, stagedOutput_, loss, normalizeGradient);
+  } else {
+    auto loss = createLoss(output_);
+    model_ = std::make_shared<Model>(input, output_, loss, normalizeGradient);
+  }
+}
+
+void FastText::loadModel(std::istream& in, storage_type inputStorage) {
+  loadModel(in, inputStorage, "", 1);
+}
+
+void FastText::loadModel(
+    std::istream& in,
+    storage_type inputStorage,
+    const std::string& filename,
+    int32_t nthreads) {
   args_ = std::make_shared<Args>();
   input_ = std::make_shared<DenseMatrix>();
   output_ = std::make_shared<DenseMatrix>();
@@ -252,8 +308,10 @@ void FastText::loadModel(std::istream& in) {
   if (quant_input) {
     quant_ = true;
     input_ = std::make_shared<QuantMatrix>();
+  } else if (inputStorage != storage_type::fp32) {
+    input_ = std::make_shared<HalfMatrix>(inputStorage);
   }
-  input_->load(in);
+  input_->load(in, filename, nthreads);
 
   if (!quant_input && dict_->isPruned()) {
     throw std::invalid_argument(
@@ -266,7 +324,7 @@ void FastText::loadModel(std::istream& in) {
   if (quant_ && args_->qout) {
     output_ = std::make_shared<QuantMatrix>();
   }
-  output_->load(in);
+  output_->load(in, filename, nthreads);
 
   buildModel();
 }
@@ -321,9 +379,25 @@ std::vector<int32_t> FastText::selectEmbeddings(int32_t cutoff) const {
 }
 
 void FastText::quantize(const Args& qargs, const TrainCallback& callback) {
-  if (args_->model != model_name::sup) {
+  quantizeModel(qargs, nullptr, callback);
+}
+
+void FastText::quantize(
+    const Args& qargs,
+    std::istream& in,
+    const TrainCallback& callback) {
+  quantizeModel(qargs, &in, callback);
+}
+
+void FastText::quantizeModel(
+    const Args& qargs,
+    std::istream* in,
+    const TrainCallback& callback) {
+  // Word vector models are only compressed for queries, retraining them
+  // would need the whole unsupervised corpus again.
+  if (args_->model != model_name::sup && qargs.retrain) {
     throw std::invalid_argument(
-        "For now we only support quantization of supervised models");
+        "For now we only support retraining of quantized supervised models");
   }
   args_->input = qargs.input;
   args_->qout = qargs.qout;
@@ -332,6 +406,10 @@ void FastText::quantize(const Args& qargs, const TrainCallback& callback) {
       std::dynamic_pointer_cast<DenseMatrix>(input_);
   std::shared_ptr<DenseMatrix> output =
       std::dynamic_pointer_cast<DenseMatrix>(output_);
+  if (!input) {
+    throw std::invalid_argument(
+        "Only models loaded in full precision can be quantized");
+  }
   bool normalizeGradient = (args_->model == model_name::sup);
 
   if (qargs.cutoff > 0 && qargs.cutoff < input->size(0)) {
@@ -350,9 +428,18 @@ void FastText::quantize(const Args& qargs, const TrainCallback& callback) {
       args_->lr = qargs.lr;
       args_->thread = qargs.thread;
       args_->verbose = qargs.verbose;
-      auto loss = createLoss(output_);
-      model_ = std::make_shared<Model>(input, output, loss, normalizeGradient);
+      args_->deterministic = qargs.deterministic;
+      buildTrainModel(input);
+      if (in) {
+        // Tokenized with the pruned dictionary.
+        in->clear();
+        in->seekg(0, std::ios_base::beg);
+        auto corpus = std::make_shared<Corpus>(dict_, args_->model);
+        corpus->load(*in);
+        corpus_ = corpus;
+      }
       startThreads(callback);
+      corpus_.reset();
     }
   }
   input_ = std::make_shared<QuantMatrix>(
@@ -459,6 +546,18 @@ void FastText::predict(
     return;
   }
   Model::State state(args_->dim, dict_->nlabels(), 0);
+  predict(k, words, predictions, state, threshold);
+}
+
+void FastText::predict(
+    int32_t k,
+    const std::vector<int32_t>& words,
+    Predictions& predictions,
+    Model::State& state,
+    real threshold) const {
+  if (words.empty()) {
+    return;
+  }
   if (args_->model != model_name::sup) {
     throw std::invalid_argument("Model needs to be supervised for prediction!");
   }
@@ -630,18 +729,31 @@ bool FastText::keepTraining(const int64_t ntokens) const {
 }
 
 void FastText::trainThread(int32_t threadId, const TrainCallback& callback) {
-  std::ifstream ifs(args_->input);
-  utils::seek(ifs, threadId * utils::size(ifs) / args_->thread);
+  std::ifstream ifs;
+  std::unique_ptr<Corpus::Shard> shard;
+  if (corpus_) {
+    shard.reset(new Corpus::Shard(
+        *corpus_, threadId, args_->thread, args_->shuffle, args_->seed));
+  } else {
+    ifs.open(args_->input);
+    utils::seek(ifs, threadId * utils::size(ifs) / args_->thread);
+  }
 
   Model::State state(args_->dim, output_->size(0), threadId + args_->seed);
 
   const int64_t ntokens = dict_->ntokens();
+  const bool synced = stagedInput_ != nullptr;
+  if (synced) {
+    StagedMatrix::setStage(threadId);
+  }
   int64_t localTokenCount = 0;
   std::vector<int32_t> line, labels;
   uint64_t callbackCounter = 0;
   try {
-    while (keepTraining(ntokens)) {
-      real progress = real(tokenCount_) / (args_->epoch * ntokens);
+    while (synced ? !stopRounds_ : keepTraining(ntokens)) {
+      // The shared count only moves between rounds in deterministic mode.
+      real progress = real(tokenCount_ + (synced ? localTokenCount : 0)) /
+          (args_->epoch * ntokens);
       if (callback && ((callbackCounter++ % 64) == 0)) {
         double wst;
         double lr;
@@ -652,17 +764,28 @@ void FastText::trainThread(int32_t threadId, const TrainCallback& callback) {
       }
       real lr = args_->lr * (1.0 - progress);
       if (args_->model == model_name::sup) {
-        localTokenCount += dict_->getLine(ifs, line, labels);
+        localTokenCount += corpus_
+            ? corpus_->getLine(shard->next(), line, labels)
+            : dict_->getLine(ifs, line, labels);
         supervised(state, lr, line, labels);
       } else if (args_->model == model_name::cbow) {
-        localTokenCount += dict_->getLine(ifs, line, state.rng);
+        localTokenCount += corpus_
+            ? corpus_->getLine(shard->next(), line, state.rng)
+            : dict_->getLine(ifs, line, state.rng);
         cbow(state, lr, line);
       } else if (args_->model == model_name::sg) {
-        localTokenCount += dict_->getLine(ifs, line, state.rng);
+        localTokenCount += corpus_
+            ? corpus_->getLine(shard->next(), line, state.rng)
+            : dict_->getLine(ifs, line, state.rng);
         skipgram(state, lr, line);
       }
-      if (localTokenCount > args_->lrUpdateRate) {
-        tokenCount_ += localTokenCount;
+      if (synced ? localTokenCount >= kRoundTokens
+                 : localTokenCount > args_->lrUpdateRate) {
+        if (synced) {
+          syncRound(threadId, localTokenCount);
+        } else {
+          tokenCount_ += localTokenCount;
+        }
         localTokenCount = 0;
         if (threadId == 0 && args_->verbose > 1) {
           loss_ = state.getLoss();
@@ -671,12 +794,31 @@ void FastText::trainThread(int32_t threadId, const TrainCallback& callback) {
     }
   } catch (DenseMatrix::EncounteredNaNError&) {
     trainException_ = std::current_exception();
+    // The other threads wait for this one at the end of each round.
+    while (synced && !stopRounds_) {
+      syncRound(threadId, 0);
+    }
   }
   if (threadId == 0)
     loss_ = state.getLoss();
   ifs.close();
 }
 
+void FastText::syncRound(int32_t threadId, int64_t tokens) {
+  roundTokens_[threadId] = tokens;
+  barrier_->wait();
+  static_cast<StagedMatrix&>(*stagedInput_).merge(threadId, args_->thread);
+  static_cast<StagedMatrix&>(*stagedOutput_).merge(threadId, args_->thread);
+  barrier_->wait([this]() {
+    for (int64_t tokens : roundTokens_) {
+      tokenCount_ += tokens;
+    }
+    stopRounds_ = !keepTraining(dict_->ntokens());
+  });
+  static_cast<StagedMatrix&>(*stagedInput_).clearStage(threadId);
+  static_cast<StagedMatrix&>(*stagedOutput_).clearStage(threadId);
+}
+
 std::shared_ptr<Matrix> FastText::getInputMatrixFromFile(
     const std::string& filename) const {
   std::ifstream in(filename);
@@ -753,8 +895,44 @@ void FastText::train(const Args& args, const TrainCallback& callback) {
         args_->input + " cannot be opened for training!");
   }
   dict_->readFromFile(ifs);
+
+  corpus_.reset();
+  prepareTraining();
+  if (args_->inMemory) {
+    ifs.clear();
+    ifs.seekg(0, std::ios_base::beg);
+    auto corpus = std::make_shared<Corpus>(dict_, args_->model);
+    corpus->load(ifs);
+    corpus_ = corpus;
+  }
   ifs.close();
 
+  startThreads(callback);
+  corpus_.reset();
+}
+
+void FastText::train(
+    const Args& args,
+    std::istream& in,
+    const TrainCallback& callback) {
+  args_ = std::make_shared<Args>(args);
+  dict_ = std::make_shared<Dictionary>(args_);
+  dict_->readFromFile(in);
+
+  prepareTraining();
+
+  // Must happen once the dictionary is final (pretrained vectors add words).
+  in.clear();
+  in.seekg(0, std::ios_base::beg);
+  auto corpus = std::make_shared<Corpus>(dict_, args_->model);
+  corpus->load(in);
+  corpus_ = corpus;
+
+  startThreads(callback);
+  corpus_.reset();
+}
+
+void FastText::prepareTraining() {
   if (!args_->pretrainedVectors.empty()) {
     input_ = getInputMatrixFromFile(args_->pretrainedVectors);
   } else {
@@ -762,10 +940,7 @@ void FastText::train(const Args& args, const TrainCallback& callback) {
   }
   output_ = createTrainOutputMatrix();
   quant_ = false;
-  auto loss = createLoss(output_);
-  bool normalizeGradient = (args_->model == model_name::sup);
-  model_ = std::make_shared<Model>(input_, output_, loss, normalizeGradient);
-  startThreads(callback);
+  buildTrainModel(input_);
 }
 
 void FastText::abort() {
@@ -781,6 +956,11 @@ void FastText::startThreads(const TrainCallback& callback) {
   tokenCount_ = 0;
   loss_ = -1;
   trainException_ = nullptr;
+  if (stagedInput_) {
+    barrier_.reset(new utils::Barrier(args_->thread));
+    roundTokens_.assign(args_->thread, 0);
+    stopRounds_ = false;
+  }
   std::vector<std::thread> threads;
   if (args_->thread > 1) {
     for (int32_t i = 0; i < args_->thread; i++) {
@@ -803,6 +983,17 @@ void FastText::startThreads(const TrainCallback& callback) {
   for (int32_t i = 0; i < threads.size(); i++) {
     threads[i].join();
   }
+  if (stagedInput_) {
+    // Every stage is merged: use the shared matrices from now on.
+    std::shared_ptr<Matrix> input =
+        static_cast<StagedMatrix&>(*stagedInput_).base();
+    auto loss = createLoss(output_);
+    bool normalizeGradient = (args_->model == model_name::sup);
+    model_ = std::make_shared<Model>(input, output_, loss, normalizeGradient);
+    stagedInput_.reset();
+    stagedOutput_.reset();
+    barrier_.reset();
+  }
   if (trainException_) {
     std::exception_ptr exception = trainException_;
     trainException_ = nullptr;
@@ -20,12 +20,15 @@
 #include <tuple>
 
 #include "args.h"
+#include "corpus.h"
 #include "densematrix.h"
 #include "dictionary.h"
+#include "halfmatrix.h"
 #include "matrix.h"
 #include "meter.h"
 #include "model.h"
 #include "real.h"
+#include "stagedmatrix.h"
 #include "utils.h"
 #include "vector.h"
 
@@ -42,6 +45,7 @@ class FastText {
   std::shared_ptr<Matrix> input_;
   std::shared_ptr<Matrix> output_;
   std::shared_ptr<Model> model_;
+  std::shared_ptr<const Corpus> corpus_;
   std::atomic<int64_t> tokenCount_{};
   std::atomic<real> loss_{};
   std::chrono::steady_clock::time_point start_;
@@ -49,12 +53,20 @@ class FastText {
   int32_t version;
   std::unique_ptr<DenseMatrix> wordVectors_;
   std::exception_ptr trainException_;
+  // Deterministic training: staged views of the trained matrices, and the
+  // rounds at the end of which every thread merges them.
+  std::shared_ptr<Matrix> stagedInput_;
+  std::shared_ptr<Matrix> stagedOutput_;
+  std::unique_ptr<utils::Barrier> barrier_;
+  std::vector<int64_t> roundTokens_;
+  bool stopRounds_;
 
   void signModel(std::ostream&);
   bool checkModel(std::istream&);
   void startThreads(const TrainCallback& callback = {});
   void addInputVector(Vector&, int32_t) const;
   void trainThread(int32_t, const TrainCallback& callback);
+  void syncRound(int32_t threadId, int64_t tokens);
   std::vector<std::pair<real, std::string>> getNN(
       const DenseMatrix& wordVectors,
       const Vector& queryVec,
@@ -78,6 +90,12 @@ class FastText {
   void precomputeWordVectors(DenseMatrix& wordVectors);
   bool keepTraining(const int64_t ntokens) const;
   void buildModel();
+  void buildTrainModel(const std::shared_ptr<Matrix>& input);
+  void quantizeModel(
+      const Args& qargs,
+      std::istream* in,
+      const TrainCallback& callback);
+  void prepareTraining();
   std::tuple<int64_t, double, double> progressInfo(real progress);
 
  public:
@@ -91,6 +109,9 @@ class FastText {
 
   void getWordVector(Vector& vec, const std::string& word) const;
 
+  // Average of the given input rows, e.g. subwords memoized by the caller.
+  void getWordVector(Vector& vec, const std::vector<int32_t>& subwords) const;
+
   void getSubwordVector(Vector& vec, const std::string& subword) const;
 
   inline void getInputVector(Vector& vec, int32_t ind) {
@@ -114,16 +135,37 @@ class FastText {
 
   void saveModel(const std::string& filename);
 
+  void saveModel(std::ostream& out);
+
   void saveOutput(const std::string& filename);
 
-  void loadModel(std::istream& in);
+  void loadModel(
+      std::istream& in,
+      storage_type inputStorage = storage_type::fp32);
+
+  void loadModel(
+      const std::string& filename,
+      storage_type inputStorage = storage_type::fp32,
+      int32_t nthreads = 1);
 
-  void loadModel(const std::string& filename);
+  // `in` reads the model file `filename`, whose matrices are then read by
+  // `nthreads` threads.
+  void loadModel(
+      std::istream& in,
+      storage_type inputStorage,
+      const std::string& filename,
+      int32_t nthreads);
 
   void getSentenceVector(std::istream& in, Vector& vec);
 
   void quantize(const Args& qargs, const TrainCallback& callback = {});
 
+  // Retrains (when asked to) on the given corpus instead of qargs.input.
+  void quantize(
+      const Args& qargs,
+      std::istream& in,
+      const TrainCallback& callback = {});
+
   std::tuple<int64_t, double, double>
   test(std::istream& in, int32_t k, real threshold = 0.0);
 
@@ -135,6 +177,13 @@ class FastText {
       Predictions& predictions,
       real threshold = 0.0) const;
 
+  void predict(
+      int32_t k,
+      const std::vector<int32_t>& words,
+      Predictions& predictions,
+      Model::State& state,
+      real threshold = 0.0) const;
+
   bool predictLine(
       std::istream& in,
       std::vector<std::pair<real, std::string>>& predictions,
@@ -156,6 +205,11 @@ class FastText {
 
   void train(const Args& args, const TrainCallback& callback = {});
 
+  void train(
+      const Args& args,
+      std::istream& in,
+      const TrainCallback& callback = {});
+
   void abort();
 
   int getDimension() const;
@@ -0,0 +1,167 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "halfmatrix.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+#include "utils.h"
+#include "vecmath.h"
+#include "vector.h"
+
+namespace fasttext {
+
+namespace {
+
+// Rows are widened by chunks small enough to stay on the stack.
+const int64_t kChunk = 128;
+
+// Floats read or written at once when converting from/to the file format.
+const int64_t kIoChunk = 1 << 16;
+
+} // namespace
+
+HalfMatrix::HalfMatrix(storage_type type) : Matrix(), type_(type) {
+  if (type_ != storage_type::fp16 && type_ != storage_type::bf16) {
+    throw std::invalid_argument("HalfMatrix needs fp16 or bf16 storage");
+  }
+}
+
+void HalfMatrix::widen(const uint16_t* src, real* dst, int64_t n) const {
+  if (type_ == storage_type::fp16) {
+    vecmath::fp16ToFloat(src, dst, n);
+  } else {
+    vecmath::bf16ToFloat(src, dst, n);
+  }
+}
+
+void HalfMatrix::narrow(const real* src, uint16_t* dst, int64_t n) const {
+  if (type_ == storage_type::fp16) {
+    vecmath::floatToFp16(src, dst, n);
+  } else {
+    vecmath::floatToBf16(src, dst, n);
+  }
+}
+
+real HalfMatrix::dotRow(const Vector& vec, int64_t i) const {
+  assert(i >= 0);
+  assert(i < m_);
+  assert(vec.size() == n_);
+  real buffer[kChunk];
+  const uint16_t* row = data_.data() + i * n_;
+  real d = 0.0;
+  for (int64_t j = 0; j < n_; j += kChunk) {
+    int64_t n = std::min(kChunk, n_ - j);
+    widen(row + j, buffer, n);
+    d += vecmath::dot(buffer, vec.data() + j, n);
+  }
+  return d;
+}
+
+void HalfMatrix::addVectorToRow(const Vector&, int64_t, real) {
+  throw std::runtime_error(
+      "Operation not permitted on half-precision matrices.");
+}
+
+void HalfMatrix::addRowToVector(Vector& x, int32_t i) const {
+  assert(i >= 0);
+  assert(i < this->size(0));
+  assert(x.size() == this->size(1));
+  real buffer[kChunk];
+  const uint16_t* row = data_.data() + i * n_;
+  for (int64_t j = 0; j < n_; j += kChunk) {
+    int64_t n = std::min(kChunk, n_ - j);
+    widen(row + j, buffer, n);
+    vecmath::add(buffer, x.data() + j, n);
+  }
+}
+
+void HalfMatrix::addRowToVector(Vector& x, int32_t i, real a) const {
+  assert(i >= 0);
+  assert(i < this->size(0));
+  assert(x.size() == this->size(1));
+  real buffer[kChunk];
+  const uint16_t* row = data_.data() + i * n_;
+  for (int64_t j = 0; j < n_; j += kChunk) {
+    int64_t n = std::min(kChunk, n_ - j);
+    widen(row + j, buffer, n);
+    vecmath::axpy(a, buffer, x.data() + j, n);
+  }
+}
+
+void HalfMatrix::save(std::ostream& out) const {
+  out.write((char*)&m_, sizeof(int64_t));
+  out.write((char*)&n_, sizeof(int64_t));
+  std::vector<real> buffer(std::min(kIoChunk, int64_t(data_.size())));
+  for (int64_t k = 0; k < int64_t(data_.size()); k += kIoChunk) {
+    int64_t n = std::min(kIoChunk, int64_t(data_.size()) - k);
+    widen(data_.data() + k, buffer.data(), n);
+    out.write((char*)buffer.data(), n * sizeof(real));
+  }
+}
+
+void HalfMatrix::load(std::istream& in) {
+  in.read((char*)&m_, sizeof(int64_t));
+  in.read((char*)&n_, sizeof(int64_t));
+  // Converted while streaming, the float32 matrix is never fully in memory.
+  data_ = std::vector<uint16_t>(m_ * n_);
+  std::vector<real> buffer(std::min(kIoChunk, m_ * n_));
+  for (int64_t k = 0; k < m_ * n_; k += kIoChunk) {
+    int64_t n = std::min(kIoChunk, m_ * n_ - k);
+    in.read((char*)buffer.data(), n * sizeof(real));
+    narrow(buffer.data(), data_.data() + k, n);
+  }
+}
+
+void HalfMatrix::load(
+    std::istream& in,
+    const std::string& filename,
+    int32_t nthreads) {
+  if (nthreads <= 1) {
+    load(in);
+    return;
+  }
+  in.read((char*)&m_, sizeof(int64_t));
+  in.read((char*)&n_, sizeof(int64_t));
+  data_ = std::vector<uint16_t>(m_ * n_);
+  int64_t offset = in.tellg();
+  utils::readParallel(
+      filename,
+      offset,
+      m_ * n_,
+      sizeof(real),
+      nthreads,
+      [this](std::istream& ifs, int64_t begin, int64_t end) {
+        std::vector<real> buffer(std::min(kIoChunk, end - begin));
+        for (int64_t k = begin; k < end; k += kIoChunk) {
+          int64_t n = std::min(kIoChunk, end - k);
+          ifs.read((char*)buffer.data(), n * sizeof(real));
+          narrow(buffer.data(), data_.data() + k, n);
+        }
+      });
+  in.seekg(std::streampos(offset + m_ * n_ * sizeof(real)));
+}
+
+void HalfMatrix::dump(std::ostream& out) const {
+  out << m_ << " " << n_ << std::endl;
+  std::vector<real> row(n_);
+  for (int64_t i = 0; i < m_; i++) {
+    widen(data_.data() + i * n_, row.data(), n_);
+    for (int64_t j = 0; j < n_; j++) {
+      if (j > 0) {
+        out << " ";
+      }
+      out << row[j];
+    }
+    out << std::endl;
+  }
+}
+
+} // namespace fasttext
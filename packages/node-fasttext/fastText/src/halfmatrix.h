@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "matrix.h"
+#include "real.h"
+
+namespace fasttext {
+
+class Vector;
+
+enum class storage_type : int { fp32 = 0, fp16, bf16 };
+
+/**
+ * Read-only matrix keeping its values in 16 bits (IEEE half or bfloat16).
+ * Rows are widened to float on the fly, which halves the memory of a loaded
+ * input matrix at the price of a small loss of precision. It is saved and
+ * loaded in the DenseMatrix file format, so model files are unchanged.
+ */
+class HalfMatrix : public Matrix {
+ protected:
+  storage_type type_;
+  std::vector<uint16_t> data_;
+
+  void widen(const uint16_t* src, real* dst, int64_t n) const;
+  void narrow(const real* src, uint16_t* dst, int64_t n) const;
+
+ public:
+  explicit HalfMatrix(storage_type);
+  HalfMatrix(const HalfMatrix&) = delete;
+  HalfMatrix(HalfMatrix&&) = delete;
+  HalfMatrix& operator=(const HalfMatrix&) = delete;
+  HalfMatrix& operator=(HalfMatrix&&) = delete;
+  virtual ~HalfMatrix() noexcept override = default;
+
+  storage_type type() const {
+    return type_;
+  }
+
+  real dotRow(const Vector&, int64_t) const override;
+  void addVectorToRow(const Vector&, int64_t, real) override;
+  void addRowToVector(Vector& x, int32_t i) const override;
+  void addRowToVector(Vector& x, int32_t i, real a) const override;
+  void save(std::ostream&) const override;
+  void load(std::istream&) override;
+  void load(std::istream& in, const std::string& filename, int32_t nthreads)
+      override;
+  void dump(std::ostream&) const override;
+};
+
+} // namespace fasttext
@@ -22,4 +22,8 @@ int64_t Matrix::size(int64_t dim) const {
   return n_;
 }
 
+void Matrix::load(std::istream& in, const std::string&, int32_t) {
+  load(in);
+}
+
 } // namespace fasttext
@@ -11,6 +11,7 @@
 #include <cstdint>
 #include <istream>
 #include <ostream>
+#include <string>
 #include <vector>
 
 #include <assert.h>
@@ -38,6 +39,12 @@ class Matrix {
   virtual void addRowToVector(Vector& x, int32_t i, real a) const = 0;
   virtual void save(std::ostream&) const = 0;
   virtual void load(std::istream&) = 0;
+  // Same as load(in), `in` reading the file `filename`: the data may then be
+  // read by `nthreads` threads, each with its own stream on the file.
+  virtual void load(
+      std::istream& in,
+      const std::string& filename,
+      int32_t nthreads);
   virtual void dump(std::ostream&) const = 0;
 };
 
@@ -8,14 +8,25 @@
 
 #include "productquantizer.h"
 
+#include <assert.h>
+
 #include <algorithm>
 #include <iostream>
 #include <numeric>
 #include <stdexcept>
 #include <string>
 
+#include "vecmath.h"
+
 namespace fasttext {
 
+namespace {
+
+// Sub-quantizers decoded at once by the 2-float gather path.
+const int32_t kDecodeChunk = 64;
+
+} // namespace
+
 real distL2(const real* x, const real* y, int32_t d) {
   real dist = 0;
   for (auto i = 0; i < d; i++) {
@@ -180,16 +191,23 @@ real ProductQuantizer::mulcode(
     int32_t t,
     real alpha) const {
   real res = 0.0;
-  auto d = dsub_;
   const uint8_t* code = codes + nsubq_ * t;
-  for (auto m = 0; m < nsubq_; m++) {
-    const real* c = get_centroids(m, code[m]);
+  int32_t m = 0;
+  if (dsub_ == 2) {
+    real buffer[2 * kDecodeChunk];
+    for (; m < nsubq_ - 1; m += kDecodeChunk) {
+      int32_t n = std::min(kDecodeChunk, nsubq_ - 1 - m);
+      decodePairs(code, m, n, buffer);
+      res += vecmath::dot(buffer, x.data() + m * dsub_, 2 * n);
+    }
+    m = nsubq_ - 1;
+  }
+  auto d = dsub_;
+  for (; m < nsubq_; m++) {
     if (m == nsubq_ - 1) {
       d = lastdsub_;
     }
-    for (auto n = 0; n < d; n++) {
-      res += x[m * dsub_ + n] * c[n];
-    }
+    res += vecmath::dot(get_centroids(m, code[m]), x.data() + m * dsub_, d);
   }
   return res * alpha;
 }
@@ -199,19 +217,61 @@ void ProductQuantizer::addcode(
     const uint8_t* codes,
     int32_t t,
     real alpha) const {
-  auto d = dsub_;
   const uint8_t* code = codes + nsubq_ * t;
+  int32_t m = 0;
+  if (dsub_ == 2) {
+    real buffer[2 * kDecodeChunk];
+    for (; m < nsubq_ - 1; m += kDecodeChunk) {
+      int32_t n = std::min(kDecodeChunk, nsubq_ - 1 - m);
+      decodePairs(code, m, n, buffer);
+      vecmath::axpy(alpha, buffer, x.data() + m * dsub_, 2 * n);
+    }
+    m = nsubq_ - 1;
+  }
+  auto d = dsub_;
+  for (; m < nsubq_; m++) {
+    if (m == nsubq_ - 1) {
+      d = lastdsub_;
+    }
+    vecmath::axpy(alpha, get_centroids(m, code[m]), x.data() + m * dsub_, d);
+  }
+}
+
+void ProductQuantizer::decodePairs(
+    const uint8_t* code,
+    int32_t m,
+    int32_t n,
+    real* x) const {
+  assert(dsub_ == 2 && m + n < nsubq_);
+  vecmath::gatherPairs(get_centroids(m, 0), code + m, ksub_, n, x);
+}
+
+void ProductQuantizer::computeDotTable(const Vector& x, real* table) const {
+  auto d = dsub_;
   for (auto m = 0; m < nsubq_; m++) {
-    const real* c = get_centroids(m, code[m]);
     if (m == nsubq_ - 1) {
       d = lastdsub_;
     }
-    for (auto n = 0; n < d; n++) {
-      x[m * dsub_ + n] += alpha * c[n];
+    const real* xsub = x.data() + m * dsub_;
+    for (auto k = 0; k < ksub_; k++) {
+      table[m * ksub_ + k] = vecmath::dot(get_centroids(m, k), xsub, d);
     }
   }
 }
 
+real ProductQuantizer::mulcode(
+    const real* table,
+    const uint8_t* codes,
+    int32_t t,
+    real alpha) const {
+  const uint8_t* code = codes + nsubq_ * t;
+  real res = 0.0;
+  for (auto m = 0; m < nsubq_; m++) {
+    res += table[m * ksub_ + code[m]];
+  }
+  return res * alpha;
+}
+
 void ProductQuantizer::compute_code(const real* x, uint8_t* code) const {
   auto d = dsub_;
   for (auto m = 0; m < nsubq_; m++) {
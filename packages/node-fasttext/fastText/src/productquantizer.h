@@ -38,6 +38,8 @@ class ProductQuantizer {
 
   std::minstd_rand rng;
 
+  void decodePairs(const uint8_t*, int32_t, int32_t, real*) const;
+
  public:
   ProductQuantizer() {}
   ProductQuantizer(int32_t, int32_t);
@@ -53,6 +55,16 @@ class ProductQuantizer {
 
   real mulcode(const Vector&, const uint8_t*, int32_t, real) const;
   void addcode(Vector&, const uint8_t*, int32_t, real) const;
+
+  // Asymmetric distance computation: the table holds the dot products of x
+  // with every centroid (nsubq * ksub values), so that a dot product with an
+  // encoded vector is nsubq lookups.
+  void computeDotTable(const Vector& x, real* table) const;
+  real mulcode(const real* table, const uint8_t*, int32_t, real) const;
+  int32_t dotTableSize() const {
+    return nsubq_ * ksub_;
+  }
+
   void compute_code(const real*, uint8_t*) const;
   void compute_codes(const real*, uint8_t*, int32_t) const;
 
@@ -60,6 +60,23 @@ real QuantMatrix::dotRow(const Vector& vec, int64_t i) const {
   return pq_->mulcode(vec, codes_.data(), i, norm);
 }
 
+void QuantMatrix::computeDotTable(const Vector& vec, std::vector<real>& table)
+    const {
+  assert(vec.size() == n_);
+  table.resize(pq_->dotTableSize());
+  pq_->computeDotTable(vec, table.data());
+}
+
+real QuantMatrix::dotRow(const std::vector<real>& table, int64_t i) const {
+  assert(i >= 0);
+  assert(i < m_);
+  real norm = 1;
+  if (qnorm_) {
+    norm = npq_->get_centroids(0, norm_codes_[i])[0];
+  }
+  return pq_->mulcode(table.data(), codes_.data(), i, norm);
+}
+
 void QuantMatrix::addVectorToRow(const Vector&, int64_t, real) {
   throw std::runtime_error("Operation not permitted on quantized matrices.");
 }
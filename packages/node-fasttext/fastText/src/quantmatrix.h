@@ -49,6 +49,12 @@ class QuantMatrix : public Matrix {
   void quantize(DenseMatrix&& mat);
 
   real dotRow(const Vector&, int64_t) const override;
+
+  // Scores many rows against one vector: the table is computed once, then
+  // every dotRow is a sum of lookups (asymmetric distance computation).
+  void computeDotTable(const Vector&, std::vector<real>&) const;
+  real dotRow(const std::vector<real>&, int64_t) const;
+
   void addVectorToRow(const Vector&, int64_t, real) override;
   void addRowToVector(Vector& x, int32_t i) const override;
   void addRowToVector(Vector& x, int32_t i, real a) const override;
@@ -0,0 +1,142 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "stagedmatrix.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "vecmath.h"
+#include "vector.h"
+
+namespace fasttext {
+
+thread_local int32_t StagedMatrix::stage_ = 0;
+
+StagedMatrix::StagedMatrix(std::shared_ptr<DenseMatrix> base, int32_t nstages)
+    : Matrix(base->size(0), base->size(1)),
+      base_(base),
+      stages_(nstages) {
+  for (auto& stage : stages_) {
+    stage.slots.assign(m_, -1);
+  }
+}
+
+void StagedMatrix::setStage(int32_t stage) {
+  stage_ = stage;
+}
+
+const real* StagedMatrix::stagedRow(int64_t i) const {
+  const Stage& stage = stages_[stage_];
+  int32_t slot = stage.slots[i];
+  return slot < 0 ? nullptr : stage.data.data() + slot * n_;
+}
+
+real* StagedMatrix::stageRow(int64_t i) {
+  Stage& stage = stages_[stage_];
+  int32_t slot = stage.slots[i];
+  if (slot < 0) {
+    slot = stage.rows.size();
+    stage.slots[i] = slot;
+    stage.rows.push_back(i);
+    stage.data.resize(stage.data.size() + n_, 0.0);
+  }
+  return stage.data.data() + slot * n_;
+}
+
+void StagedMatrix::merge(int32_t part, int32_t nparts) {
+  const int64_t begin = part * m_ / nparts;
+  const int64_t end = (part + 1) * m_ / nparts;
+  const size_t nstages = stages_.size();
+  for (size_t s = 0; s < nstages; s++) {
+    const Stage& stage = stages_[s];
+    for (int64_t i : stage.rows) {
+      if (i < begin || i >= end) {
+        continue;
+      }
+      // Each row is merged once, by the first stage that touched it.
+      bool merged = false;
+      for (size_t t = 0; t < s && !merged; t++) {
+        merged = stages_[t].slots[i] >= 0;
+      }
+      if (merged) {
+        continue;
+      }
+      int32_t count = 0;
+      for (size_t t = s; t < nstages; t++) {
+        count += stages_[t].slots[i] >= 0;
+      }
+      real* row = base_->data() + i * n_;
+      for (size_t t = s; t < nstages; t++) {
+        int32_t slot = stages_[t].slots[i];
+        if (slot >= 0) {
+          vecmath::axpy(
+              1.0 / count, stages_[t].data.data() + slot * n_, row, n_);
+        }
+      }
+    }
+  }
+}
+
+void StagedMatrix::clearStage(int32_t index) {
+  Stage& stage = stages_[index];
+  for (int64_t i : stage.rows) {
+    stage.slots[i] = -1;
+  }
+  stage.rows.clear();
+  stage.data.clear();
+}
+
+real StagedMatrix::dotRow(const Vector& vec, int64_t i) const {
+  real d = base_->dotRow(vec, i);
+  const real* row = stagedRow(i);
+  if (row) {
+    d += vecmath::dot(row, vec.data(), n_);
+    if (std::isnan(d)) {
+      throw DenseMatrix::EncounteredNaNError();
+    }
+  }
+  return d;
+}
+
+void StagedMatrix::addVectorToRow(const Vector& vec, int64_t i, real a) {
+  assert(i >= 0);
+  assert(i < m_);
+  assert(vec.size() == n_);
+  vecmath::axpy(a, vec.data(), stageRow(i), n_);
+}
+
+void StagedMatrix::addRowToVector(Vector& x, int32_t i) const {
+  base_->addRowToVector(x, i);
+  const real* row = stagedRow(i);
+  if (row) {
+    vecmath::add(row, x.data(), n_);
+  }
+}
+
+void StagedMatrix::addRowToVector(Vector& x, int32_t i, real a) const {
+  base_->addRowToVector(x, i, a);
+  const real* row = stagedRow(i);
+  if (row) {
+    vecmath::axpy(a, row, x.data(), n_);
+  }
+}
+
+void StagedMatrix::save(std::ostream& out) const {
+  base_->save(out);
+}
+
+void StagedMatrix::load(std::istream&) {
+  throw std::runtime_error("Operation not permitted on staged matrices.");
+}
+
+void StagedMatrix::dump(std::ostream& out) const {
+  base_->dump(out);
+}
+
+} // namespace fasttext
@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "densematrix.h"
+#include "matrix.h"
+#include "real.h"
+
+namespace fasttext {
+
+class Vector;
+
+/**
+ * View over a dense matrix used for deterministic multi-threaded training.
+ * Updates are not written to the shared matrix but staged per thread (each
+ * thread selects its stage with setStage), and reads see the shared values
+ * plus the updates staged by the calling thread. Stages are merged into the
+ * shared matrix in stage order, so the result only depends on the updates,
+ * never on the scheduling of the threads. A row updated by several stages
+ * receives the mean of their updates, which keeps rows shared by every
+ * example (e.g. the labels) from overshooting. Staging costs 4 bytes per row
+ * and stage plus the rows touched between two merges.
+ */
+class StagedMatrix : public Matrix {
+ protected:
+  struct Stage {
+    std::vector<int32_t> slots;
+    std::vector<int64_t> rows;
+    std::vector<real> data;
+  };
+
+  std::shared_ptr<DenseMatrix> base_;
+  std::vector<Stage> stages_;
+
+  static thread_local int32_t stage_;
+
+  const real* stagedRow(int64_t i) const;
+  real* stageRow(int64_t i);
+
+ public:
+  StagedMatrix(std::shared_ptr<DenseMatrix>, int32_t nstages);
+  StagedMatrix(const StagedMatrix&) = delete;
+  StagedMatrix(StagedMatrix&&) = delete;
+  StagedMatrix& operator=(const StagedMatrix&) = delete;
+  StagedMatrix& operator=(StagedMatrix&&) = delete;
+  virtual ~StagedMatrix() noexcept override = default;
+
+  std::shared_ptr<DenseMatrix> base() const {
+    return base_;
+  }
+
+  static void setStage(int32_t stage);
+
+  // Merges the stages into the rows of the given slice of the shared
+  // matrix. Slices can be merged concurrently.
+  void merge(int32_t part, int32_t nparts);
+  void clearStage(int32_t stage);
+
+  real dotRow(const Vector&, int64_t) const override;
+  void addVectorToRow(const Vector&, int64_t, real) override;
+  void addRowToVector(Vector& x, int32_t i) const override;
+  void addRowToVector(Vector& x, int32_t i, real a) const override;
+  void save(std::ostream&) const override;
+  void load(std::istream&) override;
+  void dump(std::ostream&) const override;
+};
+
+} // namespace fasttext
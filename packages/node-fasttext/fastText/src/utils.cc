@@ -10,6 +10,8 @@
 
 #include <iomanip>
 #include <ios>
+#include <stdexcept>
+#include <thread>
 
 namespace fasttext {
 
@@ -44,10 +46,67 @@ std::ostream& operator<<(std::ostream& out, const ClockPrint& me) {
   return out;
 }
 
+namespace {
+
+// Ranges smaller than this are not worth a thread of their own.
+const int64_t kMinReadBytes = 1 << 20;
+
+} // namespace
+
+void readParallel(
+    const std::string& filename,
+    int64_t offset,
+    int64_t count,
+    int64_t itemSize,
+    int32_t nthreads,
+    const std::function<void(std::istream&, int64_t, int64_t)>& read) {
+  int64_t maxThreads = std::max(int64_t(1), count * itemSize / kMinReadBytes);
+  int64_t n = std::max(int64_t(1), std::min(int64_t(nthreads), maxThreads));
+  std::vector<char> failed(n, 0);
+  auto readRange = [&](int64_t i) {
+    int64_t begin = count * i / n;
+    int64_t end = count * (i + 1) / n;
+    std::ifstream in(filename, std::ifstream::binary);
+    in.seekg(std::streampos(offset + begin * itemSize));
+    if (in) {
+      read(in, begin, end);
+    }
+    failed[i] = !in;
+  };
+  std::vector<std::thread> threads;
+  for (int64_t i = 1; i < n; i++) {
+    threads.push_back(std::thread(readRange, i));
+  }
+  readRange(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (std::find(failed.begin(), failed.end(), 1) != failed.end()) {
+    throw std::runtime_error(filename + " cannot be read!");
+  }
+}
+
 bool compareFirstLess(const std::pair<double, double>& l, const double& r) {
   return l.first < r;
 }
 
+Barrier::Barrier(int32_t count) : count_(count), waiting_(0), generation_(0) {}
+
+void Barrier::wait(const std::function<void()>& completion) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  uint64_t generation = generation_;
+  if (++waiting_ == count_) {
+    if (completion) {
+      completion();
+    }
+    waiting_ = 0;
+    generation_++;
+    released_.notify_all();
+  } else {
+    released_.wait(lock, [&]() { return generation != generation_; });
+  }
+}
+
 } // namespace utils
 
 } // namespace fasttext
@@ -12,8 +12,12 @@
 
 #include <algorithm>
 #include <chrono>
+#include <condition_variable>
 #include <fstream>
+#include <functional>
+#include <mutex>
 #include <ostream>
+#include <string>
 #include <vector>
 
 #if defined(__clang__) || defined(__GNUC__)
@@ -65,8 +69,35 @@ class ClockPrint {
   int32_t duration_;
 };
 
+// Reads `count` items of `itemSize` bytes stored at `offset` in `filename`,
+// split in contiguous ranges read concurrently by up to `nthreads` threads.
+// Each thread opens its own stream, positioned on the first item of its range
+// before `read(in, begin, end)` is called with it.
+void readParallel(
+    const std::string& filename,
+    int64_t offset,
+    int64_t count,
+    int64_t itemSize,
+    int32_t nthreads,
+    const std::function<void(std::istream&, int64_t, int64_t)>& read);
+
 bool compareFirstLess(const std::pair<double, double>& l, const double& r);
 
+// Reusable rendezvous of a fixed number of threads. The last thread to
+// arrive runs the completion before any of them is released.
+class Barrier {
+ public:
+  explicit Barrier(int32_t count);
+  void wait(const std::function<void()>& completion = {});
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable released_;
+  int32_t count_;
+  int32_t waiting_;
+  uint64_t generation_;
+};
+
 } // namespace utils
 
 } // namespace fasttext
@@ -0,0 +1,479 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "vecmath.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#define FASTTEXT_X86
+#endif
+
+#if defined(FASTTEXT_X86) &&                                     \
+    (defined(__SSE__) || defined(_M_X64) ||                      \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define FASTTEXT_HAVE_SSE
+#include <xmmintrin.h>
+#endif
+
+#if defined(FASTTEXT_X86) &&                                         \
+    ((defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))) || \
+     defined(__clang__) || defined(_MSC_VER))
+#define FASTTEXT_HAVE_AVX2
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define FASTTEXT_TARGET_AVX2
+#else
+#include <cpuid.h>
+#define FASTTEXT_TARGET_AVX2 __attribute__((target("avx2,fma,f16c")))
+#endif
+#endif
+
+namespace fasttext {
+
+namespace vecmath {
+
+namespace {
+
+struct Kernels {
+  const char* name;
+  real (*dot)(const real*, const real*, int64_t);
+  void (*axpy)(real, const real*, real*, int64_t);
+  void (*add)(const real*, real*, int64_t);
+  void (*scale)(real, real*, int64_t);
+  void (*fp16ToFloat)(const uint16_t*, real*, int64_t);
+  void (*floatToFp16)(const real*, uint16_t*, int64_t);
+  void (*bf16ToFloat)(const uint16_t*, real*, int64_t);
+  void (*gatherPairs)(const real*, const uint8_t*, int64_t, int64_t, real*);
+};
+
+inline uint32_t asBits(float f) {
+  uint32_t u;
+  std::memcpy(&u, &f, sizeof(u));
+  return u;
+}
+
+inline float asFloat(uint32_t u) {
+  float f;
+  std::memcpy(&f, &u, sizeof(f));
+  return f;
+}
+
+inline real halfToFloat(uint16_t h) {
+  const uint32_t shiftedExp = 0x7c00u << 13;
+  uint32_t o = (h & 0x7fffu) << 13;
+  uint32_t exp = shiftedExp & o;
+  o += (127 - 15) << 23;
+  if (exp == shiftedExp) {
+    // inf or nan
+    o += (128 - 16) << 23;
+  } else if (exp == 0) {
+    // subnormal: renormalize through a float subtraction
+    o += 1 << 23;
+    o = asBits(asFloat(o) - asFloat(113 << 23));
+  }
+  o |= (h & 0x8000u) << 16;
+  return asFloat(o);
+}
+
+inline uint16_t floatToHalf(real f) {
+  uint32_t u = asBits(f);
+  uint32_t sign = u & 0x80000000u;
+  u ^= sign;
+  uint16_t o;
+  if (u >= (127u + 16) << 23) {
+    // overflow to inf, or nan
+    o = u > (255u << 23) ? 0x7e00 : 0x7c00;
+  } else if (u < (113u << 23)) {
+    // subnormal or zero: let the float adder do the rounding
+    const float magic = asFloat(((127 - 15) + (23 - 10) + 1) << 23);
+    o = asBits(asFloat(u) + magic) - asBits(magic);
+  } else {
+    uint32_t mantOdd = (u >> 13) & 1;
+    u += ((uint32_t)(15 - 127) << 23) + 0xfff + mantOdd;
+    o = u >> 13;
+  }
+  return o | (sign >> 16);
+}
+
+void fp16ToFloatScalar(const uint16_t* src, real* dst, int64_t n) {
+  for (int64_t i = 0; i < n; i++) {
+    dst[i] = halfToFloat(src[i]);
+  }
+}
+
+void floatToFp16Scalar(const real* src, uint16_t* dst, int64_t n) {
+  for (int64_t i = 0; i < n; i++) {
+    dst[i] = floatToHalf(src[i]);
+  }
+}
+
+void bf16ToFloatScalar(const uint16_t* src, real* dst, int64_t n) {
+  for (int64_t i = 0; i < n; i++) {
+    dst[i] = asFloat(uint32_t(src[i]) << 16);
+  }
+}
+
+void gatherPairsScalar(
+    const real* table,
+    const uint8_t* codes,
+    int64_t stride,
+    int64_t n,
+    real* dst) {
+  for (int64_t m = 0; m < n; m++) {
+    const real* c = table + 2 * (m * stride + codes[m]);
+    dst[2 * m] = c[0];
+    dst[2 * m + 1] = c[1];
+  }
+}
+
+#ifndef FASTTEXT_HAVE_SSE
+
+real dotScalar(const real* x, const real* y, int64_t n) {
+  real d = 0.0;
+  for (int64_t i = 0; i < n; i++) {
+    d += x[i] * y[i];
+  }
+  return d;
+}
+
+void axpyScalar(real a, const real* x, real* y, int64_t n) {
+  for (int64_t i = 0; i < n; i++) {
+    y[i] += a * x[i];
+  }
+}
+
+void addScalar(const real* x, real* y, int64_t n) {
+  for (int64_t i = 0; i < n; i++) {
+    y[i] += x[i];
+  }
+}
+
+void scaleScalar(real a, real* x, int64_t n) {
+  for (int64_t i = 0; i < n; i++) {
+    x[i] *= a;
+  }
+}
+
+#else
+
+inline real hsum(__m128 v) {
+  __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+  __m128 sums = _mm_add_ps(v, shuf);
+  shuf = _mm_movehl_ps(shuf, sums);
+  sums = _mm_add_ss(sums, shuf);
+  return _mm_cvtss_f32(sums);
+}
+
+real dotSse(const real* x, const real* y, int64_t n) {
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm_add_ps(
+        acc0, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+    acc1 = _mm_add_ps(
+        acc1, _mm_mul_ps(_mm_loadu_ps(x + i + 4), _mm_loadu_ps(y + i + 4)));
+  }
+  for (; i + 4 <= n; i += 4) {
+    acc0 = _mm_add_ps(
+        acc0, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+  }
+  real d = hsum(_mm_add_ps(acc0, acc1));
+  for (; i < n; i++) {
+    d += x[i] * y[i];
+  }
+  return d;
+}
+
+void axpySse(real a, const real* x, real* y, int64_t n) {
+  const __m128 va = _mm_set1_ps(a);
+  int64_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps(
+        y + i,
+        _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(va, _mm_loadu_ps(x + i))));
+  }
+  for (; i < n; i++) {
+    y[i] += a * x[i];
+  }
+}
+
+void addSse(const real* x, real* y, int64_t n) {
+  int64_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_loadu_ps(x + i)));
+  }
+  for (; i < n; i++) {
+    y[i] += x[i];
+  }
+}
+
+void scaleSse(real a, real* x, int64_t n) {
+  const __m128 va = _mm_set1_ps(a);
+  int64_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps(x + i, _mm_mul_ps(va, _mm_loadu_ps(x + i)));
+  }
+  for (; i < n; i++) {
+    x[i] *= a;
+  }
+}
+
+#endif // FASTTEXT_HAVE_SSE
+
+#ifdef FASTTEXT_HAVE_AVX2
+
+FASTTEXT_TARGET_AVX2 real dotAvx2(const real* x, const real* y, int64_t n) {
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  int64_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    acc0 = _mm256_fmadd_ps(
+        _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), acc0);
+    acc1 = _mm256_fmadd_ps(
+        _mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8), acc1);
+  }
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm256_fmadd_ps(
+        _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), acc0);
+  }
+  __m256 acc = _mm256_add_ps(acc0, acc1);
+  __m128 v = _mm_add_ps(
+      _mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+  v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+  v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+  real d = _mm_cvtss_f32(v);
+  for (; i < n; i++) {
+    d += x[i] * y[i];
+  }
+  return d;
+}
+
+FASTTEXT_TARGET_AVX2 void
+axpyAvx2(real a, const real* x, real* y, int64_t n) {
+  const __m256 va = _mm256_set1_ps(a);
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(
+        y + i,
+        _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+  }
+  for (; i < n; i++) {
+    y[i] += a * x[i];
+  }
+}
+
+FASTTEXT_TARGET_AVX2 void addAvx2(const real* x, real* y, int64_t n) {
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(
+        y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_loadu_ps(x + i)));
+  }
+  for (; i < n; i++) {
+    y[i] += x[i];
+  }
+}
+
+FASTTEXT_TARGET_AVX2 void scaleAvx2(real a, real* x, int64_t n) {
+  const __m256 va = _mm256_set1_ps(a);
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(x + i, _mm256_mul_ps(va, _mm256_loadu_ps(x + i)));
+  }
+  for (; i < n; i++) {
+    x[i] *= a;
+  }
+}
+
+FASTTEXT_TARGET_AVX2 void
+fp16ToFloatAvx2(const uint16_t* src, real* dst, int64_t n) {
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(
+        dst + i,
+        _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(src + i))));
+  }
+  fp16ToFloatScalar(src + i, dst + i, n - i);
+}
+
+FASTTEXT_TARGET_AVX2 void
+floatToFp16Avx2(const real* src, uint16_t* dst, int64_t n) {
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm_storeu_si128(
+        (__m128i*)(dst + i),
+        _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+  }
+  floatToFp16Scalar(src + i, dst + i, n - i);
+}
+
+FASTTEXT_TARGET_AVX2 void
+bf16ToFloatAvx2(const uint16_t* src, real* dst, int64_t n) {
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i w = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src + i)));
+    _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(_mm256_slli_epi32(w, 16)));
+  }
+  bf16ToFloatScalar(src + i, dst + i, n - i);
+}
+
+// Each pair is moved as one 64-bit lane, 4 pairs per gather.
+FASTTEXT_TARGET_AVX2 void gatherPairsAvx2(
+    const real* table,
+    const uint8_t* codes,
+    int64_t stride,
+    int64_t n,
+    real* dst) {
+  const long long* pairs = (const long long*)table;
+  const int32_t s = (int32_t)stride;
+  const __m128i rows = _mm_setr_epi32(0, s, 2 * s, 3 * s);
+  int64_t m = 0;
+  for (; m + 4 <= n; m += 4) {
+    int32_t packed;
+    std::memcpy(&packed, codes + m, sizeof(packed));
+    __m128i idx = _mm_add_epi32(
+        _mm_add_epi32(rows, _mm_set1_epi32((int32_t)(m * stride))),
+        _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed)));
+    _mm256_storeu_si256(
+        (__m256i*)(dst + 2 * m), _mm256_i32gather_epi64(pairs, idx, 8));
+  }
+  gatherPairsScalar(
+      table + 2 * m * stride, codes + m, stride, n - m, dst + 2 * m);
+}
+
+bool cpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) {
+    return false;
+  }
+  __cpuid(info, 1);
+  bool fma = (info[2] & (1 << 12)) != 0;
+  bool osxsave = (info[2] & (1 << 27)) != 0;
+  bool f16c = (info[2] & (1 << 29)) != 0;
+  if (!fma || !osxsave || !f16c || (_xgetbv(0) & 6) != 6) {
+    return false;
+  }
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_F16C)) {
+    return false;
+  }
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+
+#endif // FASTTEXT_HAVE_AVX2
+
+Kernels selectKernels() {
+#ifdef FASTTEXT_HAVE_AVX2
+  if (cpuHasAvx2()) {
+    return {"avx2",
+            dotAvx2,
+            axpyAvx2,
+            addAvx2,
+            scaleAvx2,
+            fp16ToFloatAvx2,
+            floatToFp16Avx2,
+            bf16ToFloatAvx2,
+            gatherPairsAvx2};
+  }
+#endif
+#ifdef FASTTEXT_HAVE_SSE
+  return {"sse",
+          dotSse,
+          axpySse,
+          addSse,
+          scaleSse,
+          fp16ToFloatScalar,
+          floatToFp16Scalar,
+          bf16ToFloatScalar,
+          gatherPairsScalar};
+#else
+  return {"scalar",
+          dotScalar,
+          axpyScalar,
+          addScalar,
+          scaleScalar,
+          fp16ToFloatScalar,
+          floatToFp16Scalar,
+          bf16ToFloatScalar,
+          gatherPairsScalar};
+#endif
+}
+
+const Kernels& kernels() {
+  static const Kernels k = selectKernels();
+  return k;
+}
+
+} // namespace
+
+real dot(const real* x, const real* y, int64_t n) {
+  return kernels().dot(x, y, n);
+}
+
+void axpy(real a, const real* x, real* y, int64_t n) {
+  kernels().axpy(a, x, y, n);
+}
+
+void add(const real* x, real* y, int64_t n) {
+  kernels().add(x, y, n);
+}
+
+void scale(real a, real* x, int64_t n) {
+  kernels().scale(a, x, n);
+}
+
+void fp16ToFloat(const uint16_t* src, real* dst, int64_t n) {
+  kernels().fp16ToFloat(src, dst, n);
+}
+
+void floatToFp16(const real* src, uint16_t* dst, int64_t n) {
+  kernels().floatToFp16(src, dst, n);
+}
+
+void bf16ToFloat(const uint16_t* src, real* dst, int64_t n) {
+  kernels().bf16ToFloat(src, dst, n);
+}
+
+void gatherPairs(
+    const real* table,
+    const uint8_t* codes,
+    int64_t stride,
+    int64_t n,
+    real* dst) {
+  kernels().gatherPairs(table, codes, stride, n, dst);
+}
+
+void floatToBf16(const real* src, uint16_t* dst, int64_t n) {
+  for (int64_t i = 0; i < n; i++) {
+    uint32_t u = asBits(src[i]);
+    if ((u & 0x7fffffffu) > 0x7f800000u) {
+      // keep nans quiet instead of rounding them to inf
+      dst[i] = (u >> 16) | 0x40;
+    } else {
+      dst[i] = (u + 0x7fff + ((u >> 16) & 1)) >> 16;
+    }
+  }
+}
+
+const char* isa() {
+  return kernels().name;
+}
+
+} // namespace vecmath
+
+} // namespace fasttext
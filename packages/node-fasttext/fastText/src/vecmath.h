@@ -0,0 +1,57 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "real.h"
+
+namespace fasttext {
+
+/**
+ * Dense kernels shared by the matrices and Vector. The implementation (AVX2,
+ * SSE or scalar) is picked once from the host CPU, so a single binary runs
+ * everywhere and still uses the widest instructions available.
+ */
+namespace vecmath {
+
+// sum(x[i] * y[i])
+real dot(const real* x, const real* y, int64_t n);
+
+// y += a * x
+void axpy(real a, const real* x, real* y, int64_t n);
+
+// y += x
+void add(const real* x, real* y, int64_t n);
+
+// x *= a
+void scale(real a, real* x, int64_t n);
+
+// Product quantizer decoding with 2-float sub-vectors:
+// dst[2m], dst[2m + 1] = pair number (m * stride + codes[m]) of table.
+void gatherPairs(
+    const real* table,
+    const uint8_t* codes,
+    int64_t stride,
+    int64_t n,
+    real* dst);
+
+// Conversions between float and 16-bit storage (IEEE half / bfloat16),
+// rounding to nearest even when narrowing.
+void fp16ToFloat(const uint16_t* src, real* dst, int64_t n);
+void floatToFp16(const real* src, uint16_t* dst, int64_t n);
+void bf16ToFloat(const uint16_t* src, real* dst, int64_t n);
+void floatToBf16(const real* src, uint16_t* dst, int64_t n);
+
+// Name of the selected kernels: "avx2", "sse" or "scalar".
+const char* isa();
+
+} // namespace vecmath
+
+} // namespace fasttext
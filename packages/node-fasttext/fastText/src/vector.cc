@@ -14,6 +14,7 @@
 #include <iomanip>
 
 #include "matrix.h"
+#include "vecmath.h"
 
 namespace fasttext {
 
@@ -24,31 +25,21 @@ void Vector::zero() {
 }
 
 real Vector::norm() const {
-  real sum = 0;
-  for (int64_t i = 0; i < size(); i++) {
-    sum += data_[i] * data_[i];
-  }
-  return std::sqrt(sum);
+  return std::sqrt(vecmath::dot(data_.data(), data_.data(), size()));
 }
 
 void Vector::mul(real a) {
-  for (int64_t i = 0; i < size(); i++) {
-    data_[i] *= a;
-  }
+  vecmath::scale(a, data_.data(), size());
 }
 
 void Vector::addVector(const Vector& source) {
   assert(size() == source.size());
-  for (int64_t i = 0; i < size(); i++) {
-    data_[i] += source.data_[i];
-  }
+  vecmath::add(source.data(), data_.data(), size());
 }
 
 void Vector::addVector(const Vector& source, real s) {
   assert(size() == source.size());
-  for (int64_t i = 0; i < size(); i++) {
-    data_[i] += s * source.data_[i];
-  }
+  vecmath::axpy(s, source.data(), data_.data(), size());
 }
 
 void Vector::addRow(const Matrix& A, int64_t i, real a) {
@@ -1,12 +1,13 @@
 import { getBinding } from './initialize'
-import { Classifier, Query } from './typings'
+import { Classifier, Query, QueryOptions } from './typings'
 
 type ClassifierCtor = new (modelFilename?: string) => Classifier
-type QueryCtor = new (modelFilename: string) => Query
+type QueryCtor = new (modelFilename: string, options?: QueryOptions) => Query
 
 type BindingType = {
   Classifier: ClassifierCtor
   Query: QueryCtor
+  prefetch: (modelFilename: string) => number
 }
 
 export const makeClassifier = async (modelFilename?: string) => {
@@ -14,7 +15,12 @@ export const makeClassifier = async (modelFilename?: string) => {
   return new binding.Classifier(modelFilename)
 }
 
-export const makeQuery = async (modelFilename: string) => {
+export const makeQuery = async (modelFilename: string, options?: QueryOptions) => {
   const binding = await getBinding<BindingType>()
-  return new binding.Query(modelFilename)
+  return new binding.Query(modelFilename, options)
+}
+
+export const prefetchModel = async (modelFilename: string) => {
+  const binding = await getBinding<BindingType>()
+  return binding.prefetch(modelFilename)
 }
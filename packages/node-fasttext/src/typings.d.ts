@@ -1,27 +1,77 @@
 export const makeClassifier: (modelFilename?: string) => Promise<Classifier>
-export const makeQuery: (modelFilename: string) => Promise<Query>
+export const makeQuery: (modelFilename: string, options?: QueryOptions) => Promise<Query>
+// reads the model file into the OS page cache in the background, resolves at once with its size in bytes (-1 if missing)
+export const prefetchModel: (modelFilename: string) => Promise<number>
 
 export type Classifier = {
-  loadModel(modelFilename: string): Promise<any>
-  predict(sentence: string, k: number, callback?: DoneCallback): Promise<Array<{ label: string; value: number }>>
+  loadModel(modelFilename: string, options?: LoadOptions, callback?: DoneCallback): Promise<any>
+  predict(sentence: string | Int32Array, k: number, callback?: DoneCallback): Promise<Array<{ label: string; value: number }>>
+  getIds(tokens: string[], callback?: DoneCallback): Promise<Int32Array> // input ids to pass to predict instead of a sentence
+  predictBatch(sentences: string[], k: number, threads?: number, callback?: DoneCallback): Promise<BatchPredictResult>
   train(
     command: 'supervised' | 'skipgram' | 'cbow' | 'quantize',
     options: Options,
-    callback?: DoneCallback
+    callback?: DoneCallback,
+    progress?: ProgressCallback
   ): Promise<any>
-  quantize(options: Options, callback?: DoneCallback)
+  quantize(options: Options, callback?: DoneCallback, progress?: ProgressCallback)
+  // resolves with the selected arguments, their validation `score` and `model` when `output` is omitted
+  autotune(options: AutotuneOptions, callback?: DoneCallback): Promise<any>
+  cancel(): void // aborts the running and queued train/quantize/autotune, their promises are rejected
+}
+
+export type AutotuneOptions = Partial<Options> & {
+  input: string | string[] | Buffer
+  validation: string | string[] | Buffer // validation file path, or the validation set itself
+  duration?: number // search time budget in seconds [300]
+  modelSize?: string // max size of the model, e.g. '2M', which quantizes it []
+  metric?: string // objective, f1 or f1:labelname [f1]
+  predictions?: number // number of predictions used for evaluation [1]
+}
+
+export type TrainProgress = {
+  progress: number // 0..1
+  loss: number
+  wordsPerSecPerThread: number
+  lr: number
+  eta: number // seconds
+}
+
+export type ProgressCallback = (progress: TrainProgress) => void
+
+export type BatchPredictResult = {
+  labels: string[] // all labels of the model, indexed by label id
+  ids: Int32Array // k label ids per sentence, -1 when fewer than k labels are predicted
+  values: Float32Array // k probabilities per sentence, aligned with ids
+}
+
+export type LoadOptions = {
+  // threads reading the matrices of the model file, each from its own range of the file [4]
+  loadThreads?: number
+}
+
+export type QueryOptions = LoadOptions & {
+  // in-memory precision of the word/subword vectors; 'fp16' and 'bf16' halve the memory of the model
+  storage?: 'fp32' | 'fp16' | 'bf16'
+  // max number of out-of-vocabulary tokens whose subwords are memoized [100000], 0 disables the cache
+  subwordCacheSize?: number
 }
 
 export type Query = {
   nn(word: string, neighbors: number): Promise<Array<{ label: string; value: number }>>
   getWordVector(word: string): Promise<number[]>
+  prewarm(tokens: string[], callback?: DoneCallback): Promise<number> // resolves with the number of tokens added to the cache
+  // weighted mean of the unit vectors of each utterance, packed `dim` values per utterance
+  getSentenceVectors(utterances: string[][], weights?: number[][], threads?: number, callback?: DoneCallback): Promise<Float32Array>
+  // loads the model now instead of on first use, resolves with its info, including load_bytes, load_ms and load_threads
+  load(callback?: DoneCallback): Promise<any>
 }
 
 export type Options = {
   [key: string]: any
   // The following arguments are mandatory
-  input: string // training file path
-  output: string // output file path
+  input: string | string[] | Buffer // training file path, or the corpus itself (one example per line)
+  output?: string // output file path, when omitted the trained model is returned as a Buffer in `model`
 
   // The following arguments are optional
   verbose: number // verbosity level [2]
@@ -47,6 +97,10 @@ export type Options = {
   thread: number // number of threads [12]
   pretrainedVectors: string // pretrained word vectors for supervised learning []
   saveOutput: boolean // whether output params should be saved [0]
+  seed: number // random generator seed [0]
+  inMemory: boolean // tokenize the input file once and train from memory [0]
+  shuffle: boolean // shuffle the lines of each thread every epoch, in-memory corpus only [0]
+  deterministic: boolean // reproducible training for a given seed and number of threads [0]
 
   // The following arguments for quantization are optional
   cutoff: number // number of words and ngrams to retain [0]